@@ -0,0 +1,135 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "arboricity.h"
+#include "edge_list.h"
+#include "../triangle_count.h"
+
+// Loads an edge list once and runs the steps of test_scripts/test-pipeline.sh on it: the triangle counter of ./final
+// (repeated, median time), the exact arboricity and degree statistics. The edge list is parsed in parallel and its
+// sorted edges (i < j) are both the CSR forward adjacency of the triangle counter and the input of UndirectedGraph.
+int main(int argc, char **argv) {
+    const char* data_file = NULL;
+    const char* summary_file = "results/summary.csv";
+    std::string name;
+    int repeat = 30;
+    double time_budget = -1;
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (arg == "--repeat" && a + 1 < argc) {
+            repeat = atoi(argv[++a]);
+        } else if (arg == "--time-budget" && a + 1 < argc) {
+            time_budget = atof(argv[++a]);
+        } else if (arg == "--summary" && a + 1 < argc) {
+            summary_file = argv[++a];
+        } else if (arg == "--name" && a + 1 < argc) {
+            name = argv[++a];
+        } else if (arg[0] != '-' && !data_file) {
+            data_file = argv[a];
+        } else {
+            std::cerr << "Unknown option or missing value: " << arg << "\n";
+            data_file = NULL;
+            break;
+        }
+    }
+    if (!data_file || repeat <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [--repeat N] [--time-budget SECONDS] [--summary FILE] [--name NAME] <edge list file>\n";
+        std::cerr << "  appends NAME,arboricity,,,triangles,median time to FILE (results/summary.csv by default);\n";
+        std::cerr << "  NAME defaults to the file name without directory, extension and RBL_ prefix\n";
+        return 1;
+    }
+    if (name.empty()) {
+        name = data_file;
+        name = name.substr(name.find_last_of('/') + 1);
+        name = name.substr(0, name.find_last_of('.'));
+        if (name.compare(0, 4, "RBL_") == 0) name = name.substr(4);
+    }
+
+    double start_time = omp_get_wtime();
+    EdgeList list;
+    if (!list.Load(data_file)) {
+        std::cerr << "Error opening an input file.\n";
+        return 1;
+    }
+    if (list.malformed_lines > 0) {
+        std::cerr << "Skipped " << list.malformed_lines << " malformed lines\n";
+    }
+    size_t num_vertices = list.node_num;
+    size_t num_edges = list.edges.size();
+    double parsing_marker = omp_get_wtime();
+    std::cout << "Parsing Time: " << parsing_marker - start_time << std::endl;
+
+    // forward adjacency: the edges are sorted, so the heads of node u are contiguous and increasing
+    parlay::sequence<long> offsets(num_vertices + 1, 0L);
+    if (num_edges > 0) { // parlay::histogram_by_index() divides by zero on an empty input
+        long total;
+        std::tie(offsets, total) = parlay::scan(parlay::histogram_by_index(parlay::delayed_map(list.edges, [] (const EdgeList::Edge& e) {
+            return (long)e.first;
+        }), (long)num_vertices));
+        offsets.push_back(total);
+    }
+    auto heads = parlay::map(list.edges, [] (const EdgeList::Edge& e) { return e.second; });
+    Graph g(num_vertices, offsets, heads);
+    double construction_marker = omp_get_wtime();
+    std::cout << "Adjacency List Construction Time: " << construction_marker - parsing_marker << std::endl;
+
+    std::vector<double> times(repeat);
+    long long triangles = 0;
+    for (int r = 0; r < repeat; r++) {
+        double t = omp_get_wtime();
+        Solver s(&g, list.edges);
+        s.computeTriangles();
+        times[r] = omp_get_wtime() - t;
+        if (r > 0 && s.getTriangleCount() != triangles) {
+            std::cerr << "Error: run " << r << " counted " << s.getTriangleCount() << " triangles instead of " << triangles << "\n";
+            return 1;
+        }
+        triangles = s.getTriangleCount();
+    }
+    std::sort(times.begin(), times.end());
+    double triangle_time = (repeat % 2) ? times[repeat / 2] : (times[repeat / 2 - 1] + times[repeat / 2]) / 2; // the median
+    std::cout << "Computing Triangles Time: " << triangle_time << " (median of " << repeat << ")" << std::endl;
+    std::cout << "Triangles: " << triangles << std::endl;
+
+    double arboricity_marker = omp_get_wtime();
+    UndirectedGraph* ag = new UndirectedGraph(list.node_num, num_edges);
+    ag->AddEdges(num_edges, list.edges.data(), 1);
+    ag->SetTimeBudget(time_budget);
+    int forest_num = ag->Solve();
+    std::string arboricity;
+    if (forest_num >= 0) {
+        arboricity = std::to_string(forest_num);
+    } else {
+        // out of time: the bracket [lower,upper], quoted in the CSV
+        int lower, upper;
+        ag->GetBounds(&lower, &upper);
+        std::cerr << "Time budget exceeded\n";
+        arboricity = "\"[" + std::to_string(lower) + "," + std::to_string(upper) + "]\"";
+    }
+    delete ag;
+    std::cout << "Arboricity Time: " << omp_get_wtime() - arboricity_marker << std::endl;
+    std::cout << "Arboricity: " << arboricity << std::endl;
+
+    // over the nodes with at least one edge, which come last in sorted order
+    auto degrees = parlay::sort(list.degrees);
+    long active = list.active_node_num;
+    double mean_degree = (active > 0) ? 2.0 * num_edges / active : 0;
+    int median_degree = (active > 0) ? degrees[num_vertices - active + active / 2] : 0;
+    std::cout << "Nodes: " << active << std::endl;
+    std::cout << "Edges: " << num_edges << std::endl;
+    std::cout << "Degree: max " << list.max_degree << ", mean " << mean_degree << ", median " << median_degree << std::endl;
+    std::cout << "Total Time Elapsed: " << omp_get_wtime() - start_time << std::endl;
+
+    // the columns of results/summary.csv; GBBS is a separate binary, so its columns stay empty
+    FILE* fp = fopen(summary_file, "a");
+    if (!fp) {
+        std::cerr << "Error opening " << summary_file << "\n";
+        return 1;
+    }
+    fprintf(fp, "%s,%s,,,%lld,%g\n", name.c_str(), arboricity.c_str(), triangles, triangle_time);
+    fclose(fp);
+}
@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "approximate.h"
+
+void ApproximateArboricity::Peel(double eps)
+{
+	int n = node_num;
+	round = parlay::sequence<int>(n, 0);
+	auto d = parlay::tabulate(n, [&] (int v) {
+		return parlay::reduce(parlay::delayed_map(parlay::make_slice(G.weights.begin() + G.Begin(v), G.weights.begin() + G.End(v)), [] (int w) { return (long)w; }));
+	});
+	auto alive = parlay::sequence<bool>(n, true);
+	auto active = parlay::to_sequence(parlay::iota<int>(n));
+	long m = parlay::reduce(d) / 2;
+	round_num = 0;
+
+	while (active.size() > 0)
+	{
+		// at least the nodes of degree <= average degree, and at least a fraction eps/(2+eps) of the nodes
+		double threshold = (2 + eps) * m / active.size();
+		auto b = parlay::filter(active, [&] (int v) { return d[v] <= threshold; });
+		parlay::for_each(b, [&] (int v) { alive[v] = false; round[v] = round_num; });
+		round_num ++;
+		active = parlay::filter(active, [&] (int v) { return alive[v]; });
+
+		// weighted number of removed edges per surviving neighbour
+		auto ngh = parlay::filter(parlay::flatten(parlay::map(b, [&] (int v) {
+			return parlay::delayed_tabulate(G.End(v) - G.Begin(v), [&, v] (long a) {
+				return std::pair(G.targets[G.Begin(v) + a], G.weights[G.Begin(v) + a]);
+			});
+		})), [&] (const std::pair<int,int>& uw) { return alive[uw.first]; });
+		parlay::for_each(parlay::reduce_by_key(ngh), [&] (const std::pair<int,int>& uc) { d[uc.first] -= uc.second; });
+		m = parlay::reduce(parlay::delayed_map(active, [&] (int v) { return d[v]; })) / 2;
+	}
+}
+
+// Same as UndirectedGraph::ComputeBounds(), with peeling rounds instead of cores:
+// an edge belongs to the subgraphs left before rounds r <= min(round[i], round[j]).
+void ApproximateArboricity::ComputeLowerBounds()
+{
+	lower = 0;
+	density_lower = 0;
+	if (edge_num == 0 || round_num == 0) return; // parlay's histograms divide by zero on an empty input
+	auto round_nodes = parlay::histogram_by_index(round, (long)round_num);
+	auto round_edges = parlay::reduce_by_index(parlay::delayed_tabulate(edge_num, [&] (long k) {
+		auto [i, j, w] = edges[k];
+		return std::make_pair(std::min(round[i], round[j]), (long)w);
+	}), round_num);
+
+	long n_r = 0, m_r = 0;
+	for (int r=round_num-1; r>=0; r--)
+	{
+		n_r += round_nodes[r];
+		m_r += round_edges[r];
+		if (n_r >= 1) density_lower = std::max(density_lower, (double)m_r / n_r);
+		if (n_r >= 2) lower = std::max(lower, (int)((m_r + n_r - 2) / (n_r - 1)));
+	}
+}
+
+void ApproximateArboricity::Orient()
+{
+	tail = parlay::tabulate(edge_num, [&] (long k) {
+		auto [i, j, w] = edges[k];
+		return (round[i] < round[j] || (round[i] == round[j] && i < j)) ? i : j;
+	});
+
+	// group the edges by tail; the out-edges of every node (with their copies) go to the forests 0,1,2,...
+	// in the order of their ids. Groups are small (at most upper edges), so each one is handled sequentially.
+	auto order = parlay::integer_sort(parlay::iota<long>(edge_num), [&] (long k) { return (unsigned)tail[k]; });
+	auto first = parlay::pack_index<long>(parlay::delayed_tabulate(edge_num, [&] (long p) {
+		return p == 0 || tail[order[p]] != tail[order[p-1]];
+	}));
+
+	forest = parlay::sequence<int>(edge_num, -1);
+	auto out_degree = parlay::tabulate(first.size(), [&] (size_t g) {
+		long end = (g+1 < first.size()) ? first[g+1] : edge_num;
+		int f = 0;
+		for (long p=first[g]; p<end; p++)
+		{
+			int w = std::get<2>(edges[order[p]]);
+			if (w > 0) { forest[order[p]] = f; f += w; }
+		}
+		return f;
+	});
+	upper = std::max(0, parlay::reduce(out_degree, parlay::maximum<int>())); // the identity of maximum<int> without edges
+	density_upper = upper;
+}
+
+void ApproximateArboricity::ComputeDensity(double eps, int max_iterations, double stop_above)
+{
+	int n = node_num;
+	if (n == 0 || edge_num == 0) return;
+
+	// start from the orientation: every edge is charged to its tail
+	auto load = parlay::map(parlay::reduce_by_index(parlay::delayed_tabulate(edge_num, [&] (long k) {
+		return std::make_pair(tail[k], (long)std::get<2>(edges[k]));
+	}), n), [] (long x) { return (double)x; });
+
+	for (int t=0; ; t++)
+	{
+		// any fractional orientation bounds the density from above by its largest load;
+		// the prefixes of the nodes sorted by decreasing load are candidate dense subgraphs
+		if (t == max_iterations || (t & (t-1)) == 0)
+		{
+			density_upper = std::min(density_upper, parlay::reduce(load, parlay::maximum<double>()));
+			auto order = parlay::sort(parlay::iota<int>(n), [&] (int u, int v) { return load[u] > load[v]; });
+			auto rank = parlay::sequence<int>(n);
+			parlay::parallel_for(0, n, [&] (int p) { rank[order[p]] = p; });
+			auto m = parlay::scan_inclusive(parlay::reduce_by_index(parlay::delayed_tabulate(edge_num, [&] (long k) {
+				auto [i, j, w] = edges[k];
+				return std::make_pair(std::max(rank[i], rank[j]), (long)w);
+			}), n));
+			density_lower = std::max(density_lower, parlay::reduce(parlay::delayed_tabulate(n, [&] (int p) {
+				return (double)m[p] / (p + 1);
+			}), parlay::maximum<double>()));
+			lower = std::max(lower, (int)parlay::reduce(parlay::delayed_tabulate(n, [&] (int p) {
+				return (p >= 1) ? (m[p] + p - 1) / p : 0L;
+			}), parlay::maximum<long>()));
+			if (t == max_iterations || density_upper <= (1 + eps) * density_lower) break;
+			if (stop_above >= 0 && density_lower > stop_above) break;
+		}
+
+		// Frank-Wolfe step: every edge moves towards its endpoint with the smaller load
+		auto target = parlay::reduce_by_index(parlay::delayed_tabulate(edge_num, [&] (long k) {
+			auto [i, j, w] = edges[k];
+			return std::make_pair((load[i] < load[j] || (load[i] == load[j] && i < j)) ? i : j, (double)w);
+		}), n);
+		double gamma = 2.0 / (t + 3);
+		parlay::parallel_for(0, n, [&] (int v) { load[v] = (1 - gamma) * load[v] + gamma * target[v]; });
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef __APPROXIMATE_H__
+#define __APPROXIMATE_H__
+
+#include <tuple>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+#include "degeneracy.h"
+
+// Approximate arboricity with a matching forest cover, for graphs on which the exact solver
+// (UndirectedGraph::Solve()) is too slow. Everything is parallel and runs in O(m log n) work or better.
+//
+// The nodes are peeled in rounds, and every edge is oriented from the endpoint peeled first to the other one
+// (ties broken by node id). This orientation is acyclic, so assigning the out-edges of each node
+// to distinct forests 0,1,2,... gives a cover by upper = (max out-degree) forests.
+//   eps = 0: exact degeneracy ordering (bucketed peeling, ComputeCoreness()). upper <= degeneracy <= 2*arboricity-1.
+//   eps > 0: every round removes all nodes of degree <= (2+eps)*m'/n', where the remaining graph has n' nodes and
+//            m' edges (Bahmani, Kumar and Vassilvitskii, "Densest Subgraph in Streaming and MapReduce", VLDB 2012).
+//            At most O(log(n)/eps) rounds, and upper <= (2+eps)*arboricity.
+// Every peeling round leaves an induced subgraph with n' nodes and m' edges, giving the lower bound
+// arboricity >= ceil(m'/(n'-1)).
+class ApproximateArboricity
+{
+public:
+	// edge(k) for k\in[0,edge_num-1] must return std::tuple<int,int,int> (i, j, weight);
+	// an edge of weight w counts as w parallel edges. Zero-weight edges are ignored.
+	template <class F> void Compute(int node_num, long edge_num, F edge, double eps);
+
+	// (1+eps)-approximation of the density max_S m(S)/|S| of the densest subgraph by Frank-Wolfe iterations on the
+	// fractional orientation problem (Danisch, Chan and Sozio, "Large Scale Density-friendly Graph Decomposition via
+	// Convex Programming", WWW 2017). Each iteration is a parallel pass over the edges; the nodes sorted by load give
+	// nested candidate subgraphs ("fractional peeling"), which also improve the arboricity lower bound.
+	// Stops after max_iterations iterations even if the gap is larger, or as soon as density_lower > stop_above.
+	// Must be called after Compute().
+	void ComputeDensity(double eps, int max_iterations, double stop_above = -1);
+
+	int node_num;
+	long edge_num;
+
+	int degeneracy; // -1 if Compute() was called with eps > 0
+	int round_num; // number of peeling rounds
+	int lower, upper; // lower <= arboricity <= upper; upper is the number of forests in the cover
+
+	// Edge k (with weight w) is oriented from tail[k] to the other endpoint, and its w copies are in the forests
+	// forest[k], ..., forest[k]+w-1 (forest[k] = -1 for zero-weight edges).
+	parlay::sequence<int> tail;
+	parlay::sequence<int> forest;
+	parlay::sequence<int> round; // peeling round of every node; tail[k] is the endpoint with the smaller (round, id)
+
+	// density_lower <= max_S m(S)/|S| <= density_upper. After Compute(), density_upper is the max out-degree
+	// of the orientation, i.e. upper.
+	double density_lower, density_upper;
+
+private:
+	Adjacency G;
+	parlay::sequence<std::tuple<int,int,int>> edges;
+
+	void Peel(double eps);
+	void ComputeLowerBounds(); // from the subgraphs left after every peeling round
+	void Orient();
+};
+
+template <class F> void ApproximateArboricity::Compute(int _node_num, long _edge_num, F edge, double eps)
+{
+	node_num = _node_num;
+	edge_num = _edge_num;
+	edges = parlay::tabulate(edge_num, [&] (long k) {
+		auto [i, j, w] = edge(k);
+		return std::make_tuple(i, j, w);
+	});
+	G.Build(node_num, edge_num, [&] (long k) { return edges[k]; });
+
+	if (eps > 0)
+	{
+		degeneracy = -1;
+		Peel(eps);
+	}
+	else
+	{
+		parlay::sequence<int> core;
+		degeneracy = ComputeCoreness(G, core, &round);
+		round_num = (node_num > 0) ? parlay::reduce(round, parlay::maximum<int>()) + 1 : 0;
+	}
+	ComputeLowerBounds();
+	Orient();
+}
+
+#endif
@@ -3,7 +3,12 @@
 
 #include <string.h>
 #include <assert.h>
+#include <utility>
+#include "maxflow_backend.h"
+#include "link_cut_tree.h"
+#include "solve_stats.h"
 
+class ApproximateArboricity;
 
 //#define PRINT_DEBUG
 
@@ -18,6 +23,8 @@ public:
 
 	EdgeId AddEdge(NodeId i, NodeId j, int weight); // the first call returns 0, the second returns 1, and so on.
 	                                                // In the decomposition this edge must be covered by 'weight' forests
+	EdgeId AddEdges(int num, const std::pair<NodeId,NodeId>* ij, int weight); // bulk version of AddEdge(), filled in parallel.
+	                                                                           // Returns the id of the first added edge (the k'th pair gets id+k).
 
 	int Solve(); // returns the number of forests 'forest_num'.
 	             // After calling Solve(), the k'th forest (for k\in[0,forest_num-1]) can be obtained by one of the two functions below.
@@ -30,6 +37,83 @@ public:
 	void GetForestParents(int k, EdgeId* forest); // similar to the previous function, but forest[i] is the id of the parent node, not of the parent edge.
 	                                              // Note, forest[i] \in [-1,node_num-1]
 
+	// Anytime mode: if Solve() runs for more than 'seconds' it stops (between two max-flow probes or
+	// two augmentation sweeps) and returns -1. GetBounds() then gives the bracket on forest_num found so far.
+	// A negative value (the default) means no limit.
+	void SetTimeBudget(double seconds) { time_budget = seconds; }
+	void SetMaxflowBackend(MaxflowBackend b) { maxflow_backend = b; } // used by Solve0(), MAXFLOW_ORIENTATION by default
+
+	// Parallel probing: with p > 1, Solve0() tests up to p values of k at once, each on its own copy of the max-flow network
+	// (so memory grows p times), instead of one after the other. Worth it only with idle workers. Default 1.
+	void SetParallelProbes(int p) { probe_num = p; }
+
+	// Representation of the forests in ComputeForests(). With parent pointers (the default) finding the cycle closed by an edge
+	// and re-rooting take time proportional to the depth of the trees; link-cut trees take O(log node_num) amortized time,
+	// but have larger constants and do not allow concurrent searches, so they only pay off on forests with long paths.
+	enum SpanningForestType { FOREST_PARENT_POINTERS, FOREST_LINK_CUT };
+	void SetSpanningForestType(SpanningForestType t) { forest_type = t; }
+
+	// If there is more than one connected component (the default), every component that may have the largest arboricity is
+	// relabelled into its own UndirectedGraph and solved separately, several at a time in parallel. Components whose bounds
+	// rule them out against the best lower bound found so far are covered from a degeneracy ordering instead.
+	void SetComponentSolving(bool b) { component_solving = b; }
+
+	// Core pruning (the default): with the lower bound L from the core decomposition, the nodes peeled before the last node
+	// of out-degree > L in the degeneracy orientation are removed, and only the rest (a subgraph of the (L+1)-core) is solved
+	// exactly. The peeled nodes are then added to the forests along their out-edges, which needs at most L forests.
+	void SetCorePruning(bool b) { core_pruning = b; }
+
+	// Greedy forests (off by default): maximal spanning forests are peeled off in parallel until every edge is covered, which
+	// gives an upper bound on forest_num (kept if tighter than the degeneracy), and the first of them seeds ComputeForests().
+	// This does not save augmentations: on the test graphs the degeneracy bound has been as tight, and seeding more than one
+	// forest slowed the augmentation sweeps down up to 20 times (the seeded forests leave nodes short of incoming edges, which
+	// takes long augmenting paths to repair), so only one is seeded.
+	void SetGreedyForests(bool b) { greedy_forests = b; }
+
+	// Orientation refinement (off by default): before Solve0(), the degeneracy orientation is refined by parallel local moves
+	// (see orientation_refinement.h), which bounds k0 from above, and Frank-Wolfe density iterations bound it from below
+	// (see ApproximateArboricity::ComputeDensity()), all without max-flow. If the bounds meet, the refined orientation replaces
+	// the flow of Solve0() and only ComputeForests() is left, which decides between k0 and k0+1; otherwise Solve0() probes
+	// the narrowed bracket. 'iterations' bounds the number of density iterations.
+	void SetOrientationRefinement(bool b, int iterations=16) { orientation_refinement = b; refinement_iterations = iterations; }
+	void GetBounds(int* lower, int* upper) { *lower = arboricity_lower; *upper = arboricity_upper; } // lower==upper after a complete Solve()
+
+	// Incremental mode: after a complete Solve(), adds 'num' edges as AddEdges() does (the k'th pair gets id user_edge_num+k)
+	// and inserts them into the current forests by augmenting paths. A forest is added only if the arboricity grows.
+	// Returns the new forest_num; the forests can then be read as after Solve(). The cost depends on the batch and on the part
+	// of the forests that the searches visit, not on the size of the graph, except for the first call, which converts the
+	// result of Solve() in O(forest_num*node_num + edge_num) time. The constructor's 'user_edge_num_max' must include the
+	// inserted edges, and Solve() must not be called again.
+	int InsertEdges(int num, const std::pair<NodeId,NodeId>* ij, int weight);
+
+	// Statistics (off by default): time per phase, the max-flow probes, and counters of the augmenting path searches,
+	// see solve_stats.h. GetStats() returns NULL if they are off. The search counters are per thread and always kept,
+	// which costs next to nothing; timing and collection are skipped when off.
+	void SetStats(bool b);
+	const SolveStats* GetStats() { return stats; }
+
+	// Checkpoints (off by default): Solve() saves its state to 'filename' every 'interval' seconds (between two max-flow probes
+	// or two augmentation sweeps), after Solve0() and when it returns: the bracket on k0, then the flow (the weights of all edge
+	// copies), then the compacted graph with the forests built so far. With 'resume', Solve() first reads 'filename' (if it
+	// exists and was written for the same graph) and continues from the saved state. The file is replaced by a rename, so a
+	// process killed while writing leaves the previous checkpoint. Subproblems of the reductions use 'filename' followed by
+	// ".core" or ".c<component>".
+	void SetCheckpoint(const char* filename, double interval, bool resume);
+
+	// Densest subgraph witness (off by default): Solve() also keeps a node set S of large density m(S)/|S|, where m(S) is the
+	// total weight of the edges within S. It is the source side of the minimum cut of the infeasible max-flow probe at k0-1
+	// in Solve0() (k0 <= forest_num is the minimal max-indegree of an orientation), hence
+	//   k0-1 < m(S)/|S| <= max_S' m(S')/|S'| <= k0,
+	// which costs a BFS per infeasible probe (or one max-flow if Solve0() did not run, see SetOrientationRefinement() and
+	// SetCheckpoint()). With the reductions, the witnesses of the subproblems and the densest core of the degeneracy ordering
+	// are mapped back and the densest of them is kept; the bound above then holds for the part that was solved by Solve0().
+	// If Solve() ran out of time, S comes from the largest infeasible probe so far. InducedWeight() (densest_subgraph.h)
+	// checks S against the input graph in parallel.
+	void SetDensestSubgraph(bool b) { densest_subgraph = b; }
+	int GetDensestSubgraph(NodeId* S); // S must be an array of size node_num allocated by the user. Returns |S| (0 if off or if no
+	                                   // edge has a positive weight); S[0..|S|-1] are the nodes of S in increasing order
+	long GetDensestWeight() { return densest_weight; } // m(S)
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,41 +130,88 @@ private:
 	{
 		EdgeId first_incoming;
 		int incoming; // number of incoming edges in spanning forests
-		int tmp_flag : 1; // must be kept to 0
+		char tmp_flag; // must be kept to 0
 	};
 	struct Edge
 	{
 		NodeId i[2];
 		EdgeId next_incoming;
 		int weight;
-
-#define PP_NO_PARENT            -2
-#define PP_PARENT_SAME_ENDPOINT -1
-		int path_parent;  // if >= 0 then gives the forest id 
-		Edge* path_parent_edge;
 	};
 	struct SpanningForest
 	{
-		// n = node_num+1, m = edge_num+node_num
-		SpanningForest(int n, Node* nodes);
+		// n = node_num+1, m = edge_num+node_num. 'parents' (of size n) is owned by the caller, see ParentArena
+		SpanningForest(int n, Node* nodes, Edge* edges, EdgeId* parents);
+		SpanningForest(int n, Node* nodes, Edge* edges, EdgeId* parents, int m); // backed by a link-cut tree
 		~SpanningForest();
-		NodeId GetParent(NodeId i)
+		NodeId GetParent(NodeId i) // with a link-cut tree, only after UpdateParents()
 		{
-			Edge* e = parents[i];
-			if (!e) return -1;
+			if (parents[i] < 0) return -1;
+			Edge* e = &edges[parents[i]];
 			return e->i[ (e->i[0] == i) ? 1 : 0 ];
 		}
-		bool isPresent(Edge* e) { return (parents[e->i[0]] == e || parents[e->i[1]] == e); }
+		bool isPresent(Edge* e)
+		{
+			EdgeId a = (EdgeId)(e - edges);
+			if (lct) return edge_node[a] >= 0;
+			return (parents[e->i[0]] == a || parents[e->i[1]] == a);
+		}
 		void Print();
 
 		// in the first two functions e must not be in the forest, in the last one e must be in the forest.
 		NodeId FindLCA(Edge* e); // returns lowest common ancestor of e->i[0] and e->i[1] (or -1, if in different trees).
+		NodeId FindLCA(Edge* e, char* flag, long* steps); // same, but marks nodes in 'flag' (of size n, must be kept to 0) instead of Node::tmp_flag,
+		                                                  // so that several threads can call it on the same forest (except with a link-cut tree).
+		                                                  // Adds the number of parent steps to *steps
 		void AddEdge(Edge* e, NodeId p); // p is an endpoint of e; the root of the component to which p belongs will be changed.
 		void RemoveEdge(Edge* e);
 
+		// calls f(g) for every edge g of the forest on the path between e->i[0] and e->i[1]; LCA = FindLCA(e) must be >= 0
+		template <class F> void ForEachPathEdge(Edge* e, NodeId LCA, F f)
+		{
+			if (lct)
+			{
+				lct->ForEachOnPath(e->i[0], e->i[1], [&] (int x) { if (x >= n) f(&edges[slot_edge[x - n]]); });
+				return;
+			}
+			NodeId p;
+			int d;
+			for (d=0; d<2; d++)
+			for (p=e->i[d]; p != LCA; p=GetParent(p)) f(&edges[parents[p]]);
+		}
+		void UpdateParents(); // with a link-cut tree, fills 'parents' (rooting every tree at its largest node). Otherwise does nothing
+		void SetEdges(const EdgeId* list, int num); // the forest must be empty, list[0..num-1] must be acyclic
+
 		int n;
 		Node* nodes; // of size n. Only need to access Node::tmp_flag
-		Edge** parents; // of size n
+		Edge* edges;
+		EdgeId* parents; // of size n: the parent edge of every node, -1 for roots
+
+		// link-cut tree representation: node i<n of the tree is node i of the graph, node n+s is slot s, which holds a forest edge
+		LinkCutTree* lct; // NULL if the forest is given by 'parents'
+		int* edge_node; // of size m: the tree node of every edge, -1 if the edge is not in the forest
+		EdgeId* slot_edge; // of size n
+		int* free_slots; // of size n
+		int free_slot_num;
+
+		template <class Flag> NodeId FindLCA(Edge* e, Flag flag, long* steps); // flag(i) must return a reference to the mark of node i
+		void BuildParents(const EdgeId* list, int num); // sets 'parents' to the forest list[0..num-1], by BFS from the largest node of every tree
+	};
+
+	// Memory for the parent arrays of the forests. Arrays are handed out as forests are created, from blocks
+	// of doubling size (block b holds 2^b arrays), so that they never move and there are few allocations.
+	struct ParentArena
+	{
+		ParentArena() : n(0), blocks(NULL), block_num(0), used(0), capacity(0) {}
+		~ParentArena() { Clear(); }
+		void Init(int n); // arrays will have size n
+		EdgeId* Allocate();
+		void Clear();
+
+		int n;
+		EdgeId** blocks;
+		int block_num;
+		int used, capacity; // arrays used and available in the last block
 	};
 
 	int node_num, user_edge_num, edge_num, edge_num_max; // in the beginning edge_num=2*user_edge_num (since each edge is duplicated
@@ -93,43 +224,152 @@ private:
 
 	SpanningForest** forests;
 	int forest_num;
+	ParentArena parent_arena;
 
 	struct Queue
 	{
 		Queue(int size_max_estimated=4)
 		{
 			if (size_max_estimated < 4) size_max_estimated = 4;
-			queue = (Edge**) malloc(size_max_estimated*sizeof(Edge*));
+			queue = (EdgeId*) malloc(size_max_estimated*sizeof(EdgeId));
 			queue_end_allocated = queue + size_max_estimated;
 		}
 		~Queue() { free(queue); }
 		void Init() { queue_start = queue_end = queue; }
 		void Restart() { queue_start = queue; }
-		void Add(Edge* e)
+		void Add(EdgeId e)
 		{
 			if (queue_end >= queue_end_allocated)
 			{
 				int a = (int)(queue_start - queue);
 				int b = (int)(queue_end - queue);
 				int size_max = 2*b;
-				queue = (Edge**) realloc(queue, size_max*sizeof(Edge*));
+				queue = (EdgeId*) realloc(queue, size_max*sizeof(EdgeId));
 				queue_start = queue + a;
 				queue_end = queue + b;
 				queue_end_allocated = queue + size_max;
 			}
 			*queue_end ++ = e;
 		}
-		Edge* Remove() { return (queue_start == queue_end) ? NULL : (*queue_start ++); }
+		EdgeId Remove() { return (queue_start == queue_end) ? -1 : (*queue_start ++); }
+		long Size() { return (long)(queue_end - queue); } // edges added since Init()
 	private:
-		Edge** queue;
-		Edge** queue_start;
-		Edge** queue_end;
-		Edge** queue_end_allocated;
+		EdgeId* queue;
+		EdgeId* queue_start;
+		EdgeId* queue_end;
+		EdgeId* queue_end_allocated;
+	};
+
+	// State of a Search(), kept outside of Edge so that several searches can run concurrently (one workspace per thread)
+	struct SearchWorkspace
+	{
+		SearchWorkspace(int edge_num, int node_num);
+		~SearchWorkspace();
+
+#define PP_NO_PARENT            -2
+#define PP_PARENT_SAME_ENDPOINT -1
+		int* path_parent; // of size edge_num+node_num. If >= 0 then gives the forest id
+		EdgeId* path_parent_edge; // of size edge_num+node_num, -1 for the first edge of a path
+		char* lca_flag; // of size node_num+1, see SpanningForest::FindLCA()
+		Queue queue; // edges with path_parent != PP_NO_PARENT
+		long searches, queue_pushes, lca_steps; // see SolveStats
 	};
 
-	Queue queue;
+	SearchWorkspace** workspaces; // during ComputeForests(): one per parlay worker, or a single one for the sequential sweeps
+	int workspace_num;
+	void DeleteWorkspaces();
+	void CollectSearchStats(); // adds the counters of the workspaces to 'stats' (if not NULL) and resets them
+
+	bool component_solving, core_pruning, greedy_forests, orientation_refinement;
+	int refinement_iterations;
+	bool incremental; // after InitIncremental(): the forests are over user edge copies only, edges[2k] and edges[2k+1] for user edge k
+	void InitIncremental(); // converts the result of Solve()
+	EdgeId* user_parents; // if not NULL, the result of SolveCore() or SolveComponents(): the parent edge (user id)
+	                      // of node i in forest f is user_parents[f*node_num+i]
+	ApproximateArboricity* orientation; // degeneracy orientation and its forests, shared by SolveCore() and SolveComponents()
+	void ComputeOrientation(); // if orientation==NULL
 
-	int Solve0();
+	// both return -2 if the reduction does not apply (then nothing is done), -1 if the time budget was exceeded
+	int SolveCore();
+	int SolveComponents();
+
+	// A subproblem is the graph formed by the user edges sub_edges, where node i is renamed local[i]. 'name' is appended to the checkpoint file name
+	UndirectedGraph* NewSubproblem(int sub_node_num, const EdgeId* sub_edges, long sub_edge_num, const NodeId* local, const char* name);
+	EdgeId* GetSubproblemForests(UndirectedGraph* g, const EdgeId* sub_edges); // the g->forest_num forests of g as arrays of size g->node_num
+	                                                                           // (new[]), with user edge ids of this graph
+	void AllocateUserParents(); // forest_num empty forests
+	void SetSubproblemForests(const EdgeId* F, int k, int sub_node_num, const NodeId* sub_nodes); // F as above; node l of the subproblem
+	                                                                                               // is sub_nodes[l]
+	void SetOrientationForests(const EdgeId* user_edges, long num); // covers these edges with the forests of 'orientation'
+
+	// Greedy forest cover: forest f is a maximal spanning forest of the edge copies that are not in forests 0..f-1,
+	// its user edges are greedy_edges[greedy_first[f]..greedy_first[f+1]-1]
+	EdgeId* greedy_edges;
+	long* greedy_first;
+	int greedy_forest_num;
+	void ComputeGreedyForests(); // must be called before Compact()
+	void SeedForests(int k); // creates forest 0 of ComputeForests() from the first greedy forest (if k > 0)
+
+	int k0_lower, k0_upper; // bracket on the result of Solve0()
+	int arboricity_lower, arboricity_upper; // bracket on forest_num
+	double time_budget, solve_start;
+	MaxflowBackend maxflow_backend;
+	int probe_num; // see SetParallelProbes()
+	SolveStats* stats; // NULL if off
+	SpanningForestType forest_type;
+	bool TimeBudgetExceeded();
+
+	// Densest subgraph witness, see SetDensestSubgraph() and densest_subgraph.cpp
+	bool densest_subgraph;
+	NodeId* densest; // the nodes of S in increasing order, NULL if none yet
+	int densest_num;
+	long densest_weight;
+	void SetDensest(const NodeId* S, int num, long weight); // keeps S if it is denser than the current witness
+	void RecordDensest(ArboricityMaxflow* g, const int* weights); // after an infeasible probe of Solve0(); weights of the user edges
+	void ComputeDensest(int k0, bool split); // if there is no witness yet, runs the max-flow at k0-1 (split: the weight of user edge e
+	                                          // is divided between edges[2e] and edges[2e+1], as Solve0() leaves it)
+	void DensestFromOrientation(); // the densest suffix of the peeling rounds of 'orientation' (the densest core)
+	void TakeSubproblemDensest(UndirectedGraph* g, const NodeId* sub_nodes); // the witness of g, node l of g is sub_nodes[l]
+	static double GetTime(); // seconds
+	double TimeLeft(); // for SetTimeBudget() of a subproblem
+
+	int SolvePhases(); // Solve() without the total time
+
+	// Checkpoints, see SetCheckpoint() and checkpoint.cpp
+	enum CheckpointStage { CHECKPOINT_BRACKET = 1, CHECKPOINT_FLOW, CHECKPOINT_FORESTS };
+	struct Checkpoint
+	{
+		int stage;
+		int k0_lower, k0_upper; // k0_lower==k0_upper==k0 from CHECKPOINT_FLOW on
+		int edge_num, k_current, forest_num; // CHECKPOINT_FORESTS: the compacted graph and ComputeForests(k0) so far
+		int* weights; // CHECKPOINT_FLOW: of the 2*user_edge_num copies, CHECKPOINT_FORESTS: of the edge_num+node_num compacted edges
+		int* mapping; // of size edge_num, compacting_mapping
+		NodeId* ends; // of size 2*edge_num
+		int* incoming; // of size node_num
+		EdgeId* parents; // of size forest_num*(node_num+1)
+
+		Checkpoint() : weights(NULL), mapping(NULL), ends(NULL), incoming(NULL), parents(NULL) {}
+		~Checkpoint() { delete [] weights; delete [] mapping; delete [] ends; delete [] incoming; delete [] parents; }
+	};
+	char* checkpoint_file; // NULL if off
+	double checkpoint_interval, checkpoint_last;
+	bool checkpoint_resume;
+	unsigned long long checkpoint_hash; // of the graph given by the user, so that checkpoints of another graph are not resumed
+	Checkpoint* resumed; // read at the start of Solve() (and deleted as soon as it is restored), NULL if none
+	void StartCheckpoints(); // at the start of Solve()
+	bool CheckpointDue() { return checkpoint_file && GetTime() - checkpoint_last >= checkpoint_interval; }
+	void WriteCheckpoint(CheckpointStage stage, int k_current=0); // k_current as in ComputeForests(), for CHECKPOINT_FORESTS
+	int RestoreFlow(); // returns k0 if 'resumed' has it, and sets Edge::weight as Solve0() does (unless the forests are restored);
+	                   // otherwise returns -1, after narrowing [k0_lower,k0_upper] to the saved bracket
+	void RestoreCompacted(); // instead of Compact(), if 'resumed' has the forests
+	bool RestoreForests(int* k_current); // at the start of ComputeForests(): if 'resumed' has the forests, allocates 'forests' and
+	                                      // restores them, the weights and Node::incoming
+
+	void ComputeBounds(); // initializes the brackets above from the core decomposition. Must be called before Compact()
+	int RefineOrientation(); // see SetOrientationRefinement(). Returns k0 if it is settled (then sets Edge::weight as Solve0() does),
+	                         // otherwise narrows [k0_lower,k0_upper] and returns -1
+	int Solve0(); // returns -1 if the time budget was exceeded
+	int Solve0Parallel(); // the same with probe_num > 1
 	void Compact(); // deletes edges with zero weight, allocates compacting_mapping
 
 	// all functions below can be called only after Solve0() and Compact()
@@ -138,9 +378,15 @@ private:
 	bool CheckWithMaxflow(int k); // must have k >= k0
 	                              // returns true if k_opt <= k
 	                              // Not optimized, just for testing. (Ideally, should be Hao-Orlin algorithm)
-	int ComputeForests(int k); // must have k \in [k0, k_opt]
-	Edge* Search(NodeId z);
-	void Augment(Edge* e);
+	int ComputeForests(int k); // must have k \in [k0, k_opt]. Returns -1 if the time budget was exceeded
+	Edge* Search(NodeId z, SearchWorkspace* w); // does not modify the graph, so several searches can run concurrently
+	void Augment(Edge* e, SearchWorkspace* w); // e = Search(z,w)
+
+	// Parallel version of the augmentation sweeps of ComputeForests(), used when there is more than one worker
+	void AugmentParallel(int k_current); // k_current as in ComputeForests(), for checkpoints
+	bool Augment(const std::pair<Edge*,int>* path, int len); // applies path[0..len-1] (edge, path_parent) found by Search(z,w),
+	                                                           // checking every step against the current forests.
+	                                                           // Returns false (and leaves the forests unchanged) if the path is no longer valid
 
 	void PrintEGraph();
 };
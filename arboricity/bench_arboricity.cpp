@@ -0,0 +1,218 @@
+// Benchmark of UndirectedGraph::Solve() on synthetic graphs of increasing size, for several thread counts.
+//
+// Every instance is solved twice: with the default reductions (core pruning, components), which gives the time of the
+// full Solve(), and without them, which gives the times of Solve0() and ComputeForests() on the whole graph. Times are
+// reported in microseconds per edge (the minimum over the repetitions), so that rows of different sizes are comparable.
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <parlay/parallel.h>
+#include "arboricity.h"
+
+typedef std::vector<std::pair<int,int>> EdgeVec;
+
+struct Instance
+{
+    std::string name;
+    int n;
+    EdgeVec edges;
+};
+
+static void AddEdge(EdgeVec& E, int i, int j)
+{
+    if (i != j) E.push_back(std::make_pair(i, j));
+}
+
+// r x r grid, arboricity 2
+static Instance Grid(int r)
+{
+    Instance I;
+    I.name = "grid";
+    I.n = r*r;
+    for (int i=0; i<r; i++)
+    for (int j=0; j<r; j++)
+    {
+        if (i+1 < r) AddEdge(I.edges, i*r + j, (i+1)*r + j);
+        if (j+1 < r) AddEdge(I.edges, i*r + j, i*r + j+1);
+    }
+    return I;
+}
+
+// uniform random graph with n nodes and m edges (before removing duplicates)
+static Instance Gnm(int n, long m, std::mt19937_64& rng)
+{
+    Instance I;
+    I.name = "gnm";
+    I.n = n;
+    std::uniform_int_distribution<int> node(0, n-1);
+    while ((long)I.edges.size() < m) AddEdge(I.edges, node(rng), node(rng));
+    return I;
+}
+
+// RMAT with 2^scale nodes, m edges (before removing duplicates) and the usual partition probabilities (0.57,0.19,0.19,0.05); node ids are permuted
+static Instance Rmat(int scale, long m, std::mt19937_64& rng)
+{
+    Instance I;
+    I.name = "rmat";
+    I.n = 1 << scale;
+    std::uniform_real_distribution<double> U(0, 1);
+    std::vector<int> perm(I.n);
+    for (int i=0; i<I.n; i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+    while ((long)I.edges.size() < m)
+    {
+        int i = 0, j = 0;
+        for (int b=0; b<scale; b++)
+        {
+            double x = U(rng);
+            int bi = (x >= 0.57 + 0.19) ? 1 : 0;
+            int bj = (x >= 0.57 && x < 0.57 + 0.19) || x >= 0.57 + 0.19 + 0.19;
+            i = 2*i + bi;
+            j = 2*j + bj;
+        }
+        AddEdge(I.edges, perm[i], perm[j]);
+    }
+    return I;
+}
+
+// sparse G(n,m) background plus a clique on 'c' random nodes, so that the arboricity is at least ceil(c/2)
+static Instance Planted(int n, long m, int c, std::mt19937_64& rng)
+{
+    Instance I = Gnm(n, m, rng);
+    I.name = "planted";
+    std::vector<int> perm(n);
+    for (int i=0; i<n; i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+    for (int a=0; a<c; a++)
+    for (int b=a+1; b<c; b++) AddEdge(I.edges, perm[a], perm[b]);
+    return I;
+}
+
+// keeps one copy of every parallel edge
+static void RemoveDuplicates(EdgeVec& E)
+{
+    for (auto& e : E) if (e.first > e.second) std::swap(e.first, e.second);
+    std::sort(E.begin(), E.end());
+    E.erase(std::unique(E.begin(), E.end()), E.end());
+}
+
+// simple graphs with about m edges; they are added in a random order, as the solver's running time depends on it
+static Instance Generate(const std::string& family, long m, std::mt19937_64& rng)
+{
+    Instance I;
+    if (family == "grid") { int r = 1; while (2L*r*(r+1) < m) r ++; I = Grid(r); }
+    else if (family == "gnm") I = Gnm((int)(m/5), m, rng);
+    else if (family == "rmat") { int s = 1; while ((16L << s) < m) s ++; I = Rmat(s, m, rng); }
+    else if (family == "planted") { int c = 4; while ((long)c*c < m/20) c *= 2; I = Planted((int)(m/3), m, c, rng); }
+    else { std::cerr << "Unknown graph family " << family << " (expected grid, gnm, rmat or planted)\n"; exit(1); }
+    RemoveDuplicates(I.edges);
+    std::shuffle(I.edges.begin(), I.edges.end(), rng);
+    return I;
+}
+
+struct Result
+{
+    int k;
+    double total, solve0, forests; // seconds
+};
+
+static Result Run(const Instance& I, bool reductions, MaxflowBackend backend)
+{
+    UndirectedGraph g(I.n, (int)I.edges.size());
+    g.AddEdges((int)I.edges.size(), I.edges.data(), 1);
+    g.SetMaxflowBackend(backend);
+    g.SetComponentSolving(reductions);
+    g.SetCorePruning(reductions);
+    g.SetStats(true);
+    Result r;
+    r.k = g.Solve();
+    const SolveStats* s = g.GetStats();
+    r.total = s->time_total;
+    r.solve0 = s->time_solve0;
+    r.forests = s->time_forests;
+    return r;
+}
+
+static std::vector<std::string> Split(const std::string& s)
+{
+    std::vector<std::string> parts;
+    size_t p = 0;
+    while (p <= s.size())
+    {
+        size_t q = s.find(',', p);
+        if (q == std::string::npos) q = s.size();
+        if (q > p) parts.push_back(s.substr(p, q-p));
+        p = q + 1;
+    }
+    return parts;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> families = { "grid", "gnm", "rmat", "planted" };
+    std::vector<long> sizes = { 10000, 100000 };
+    std::vector<int> threads = { 1, (int)parlay::num_workers() };
+    int repeat = 3;
+    unsigned long seed = 1;
+    MaxflowBackend backend = MAXFLOW_ORIENTATION;
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (arg == "--graphs" && a + 1 < argc) {
+            families = Split(argv[++a]);
+        } else if (arg == "--edges" && a + 1 < argc) {
+            sizes.clear();
+            for (auto& s : Split(argv[++a])) sizes.push_back(atol(s.c_str()));
+        } else if (arg == "--threads" && a + 1 < argc) {
+            threads.clear();
+            for (auto& s : Split(argv[++a])) threads.push_back(atoi(s.c_str()));
+        } else if (arg == "--repeat" && a + 1 < argc && atoi(argv[a + 1]) >= 1) {
+            repeat = atoi(argv[++a]);
+        } else if (arg == "--seed" && a + 1 < argc) {
+            seed = strtoul(argv[++a], NULL, 10);
+        } else if (arg == "--maxflow" && a + 1 < argc) {
+            std::string b = argv[++a];
+            if (b == "bk") {
+                backend = MAXFLOW_BK;
+            } else if (b == "push-relabel") {
+                backend = MAXFLOW_PUSH_RELABEL;
+            } else if (b == "orientation") {
+                backend = MAXFLOW_ORIENTATION;
+            } else {
+                std::cerr << "Unknown max-flow backend " << b << " (expected bk, push-relabel or orientation)\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--graphs grid,gnm,rmat,planted] [--edges M1,M2,...] [--threads T1,T2,...] [--repeat R] [--seed S] [--maxflow bk|push-relabel|orientation]\n";
+            return 1;
+        }
+    }
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+    printf("%-8s %10s %10s %7s %4s %12s %12s %12s %12s\n", "graph", "nodes", "edges", "threads", "k", "solve us/e", "solve0 us/e", "forests us/e", "mono us/e");
+    for (auto& family : families)
+    for (long m : sizes)
+    {
+        std::mt19937_64 rng(seed);
+        Instance I = Generate(family, m, rng);
+        double per_edge = 1e6 / (double)I.edges.size();
+        for (int t : threads)
+        {
+            Result best_full{}, best_mono{};
+            parlay::execute_with_scheduler(t, [&] {
+                for (int r=0; r<repeat; r++)
+                {
+                    Result full = Run(I, true, backend), mono = Run(I, false, backend);
+                    if (full.k != mono.k) { printf("Error: arboricity %d with reductions, %d without\n", full.k, mono.k); exit(1); }
+                    if (r == 0 || full.total < best_full.total) best_full = full;
+                    if (r == 0 || mono.total < best_mono.total) best_mono = mono;
+                }
+            });
+            printf("%-8s %10d %10ld %7d %4d %12.4f %12.4f %12.4f %12.4f\n", I.name.c_str(), I.n, (long)I.edges.size(), t, best_full.k,
+                   best_full.total*per_edge, best_mono.solve0*per_edge, best_mono.forests*per_edge, best_mono.total*per_edge);
+            fflush(stdout);
+        }
+    }
+}
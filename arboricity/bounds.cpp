@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <tuple>
+#include "arboricity.h"
+#include "degeneracy.h"
+
+// Bounds from the core decomposition (called before Compact(), when edges[2*k] is the k'th user edge).
+//
+// The k-cores are the suffixes of a degeneracy ordering, so every k-core with n_k nodes and (weighted) m_k edges gives
+//   k0 >= ceil(m_k/n_k)        (k0 = minimal max-indegree of an orientation, which is what Solve0() computes)
+//   forest_num >= ceil(m_k/(n_k-1))
+// On the other side, orienting every edge along a degeneracy ordering gives indegree <= degeneracy,
+// and the same ordering is acyclic, hence both k0 and forest_num are at most the degeneracy.
+void UndirectedGraph::ComputeBounds()
+{
+	Adjacency G;
+	G.Build(node_num, user_edge_num, [&] (long k) {
+		return std::make_tuple(edges[2*k].i[0], edges[2*k].i[1], edges[2*k].weight);
+	});
+
+	if (G.targets.empty()) // no edge of positive weight: nothing to bracket (and no input for the histograms below)
+	{
+		k0_lower = k0_upper = arboricity_lower = arboricity_upper = 0;
+		return;
+	}
+
+	parlay::sequence<int> core;
+	int degeneracy = ComputeCoreness(G, core);
+
+	// an edge belongs to the k-cores for k <= min(core[i], core[j])
+	auto core_nodes = parlay::histogram_by_index(core, (long)degeneracy+1);
+	auto core_edges = parlay::reduce_by_index(parlay::delayed_tabulate(user_edge_num, [&] (long k) {
+		return std::make_pair(std::min(core[edges[2*k].i[0]], core[edges[2*k].i[1]]), (long)edges[2*k].weight);
+	}), degeneracy+1);
+
+	long n_k = 0, m_k = 0;
+	k0_lower = arboricity_lower = 0;
+	for (int k=degeneracy; k>=0; k--)
+	{
+		n_k += core_nodes[k];
+		m_k += core_edges[k];
+		if (n_k >= 1) k0_lower = std::max(k0_lower, (int)((m_k + n_k - 1) / n_k));
+		if (n_k >= 2) arboricity_lower = std::max(arboricity_lower, (int)((m_k + n_k - 2) / (n_k - 1)));
+	}
+	k0_upper = arboricity_upper = degeneracy;
+}
@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+
+// File layout (native byte order):
+//   "ARBCKPT1", int stage, unsigned long long hash, int node_num, int user_edge_num, int k0_lower, int k0_upper
+//   CHECKPOINT_FLOW:    int weights[2*user_edge_num]
+//   CHECKPOINT_FORESTS: int edge_num, int mapping[edge_num], NodeId ends[2*edge_num], int weights[edge_num+node_num],
+//                       int incoming[node_num], int k_current, int forest_num, EdgeId parents[forest_num*(node_num+1)]
+static const char checkpoint_magic[8] = { 'A', 'R', 'B', 'C', 'K', 'P', 'T', '1' };
+
+void UndirectedGraph::SetCheckpoint(const char* filename, double interval, bool resume)
+{
+	if (checkpoint_file) { delete [] checkpoint_file; checkpoint_file = NULL; }
+	if (filename)
+	{
+		checkpoint_file = new char[strlen(filename)+1];
+		strcpy(checkpoint_file, filename);
+	}
+	checkpoint_interval = interval;
+	checkpoint_resume = resume;
+}
+
+static unsigned long long Mix(unsigned long long x)
+{
+	x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+void UndirectedGraph::StartCheckpoints()
+{
+	if (resumed) { delete resumed; resumed = NULL; }
+	if (!checkpoint_file) return;
+	checkpoint_last = GetTime();
+	checkpoint_hash = Mix(Mix(node_num) + user_edge_num) + parlay::reduce(parlay::delayed_tabulate(user_edge_num, [&] (EdgeId k) {
+		Edge* e = &edges[2*k];
+		return Mix(Mix(Mix(Mix(k) + e->i[0]) + e->i[1]) + e->weight);
+	}));
+	if (!checkpoint_resume) return;
+
+	FILE* fp = fopen(checkpoint_file, "rb");
+	if (!fp) return; // nothing to resume
+	Checkpoint* c = new Checkpoint;
+	char magic[8];
+	unsigned long long hash;
+	int n, m;
+	bool ok = true;
+	auto read = [&] (void* p, size_t size, long count) { if (ok && count > 0 && fread(p, size, count, fp) != (size_t)count) ok = false; };
+
+	read(magic, 1, 8);
+	read(&c->stage, sizeof(int), 1);
+	read(&hash, sizeof(hash), 1);
+	read(&n, sizeof(int), 1);
+	read(&m, sizeof(int), 1);
+	if (ok && (memcmp(magic, checkpoint_magic, 8) || c->stage < CHECKPOINT_BRACKET || c->stage > CHECKPOINT_FORESTS))
+	{
+		fprintf(stderr, "%s is not a checkpoint, ignored\n", checkpoint_file);
+		fclose(fp);
+		delete c;
+		return;
+	}
+	if (ok && (hash != checkpoint_hash || n != node_num || m != user_edge_num))
+	{
+		fprintf(stderr, "Checkpoint %s is for another graph, ignored\n", checkpoint_file);
+		fclose(fp);
+		delete c;
+		return;
+	}
+	read(&c->k0_lower, sizeof(int), 1);
+	read(&c->k0_upper, sizeof(int), 1);
+	if (ok && c->stage == CHECKPOINT_FLOW)
+	{
+		c->weights = new int[2*(long)user_edge_num];
+		read(c->weights, sizeof(int), 2*(long)user_edge_num);
+	}
+	if (ok && c->stage == CHECKPOINT_FORESTS)
+	{
+		read(&c->edge_num, sizeof(int), 1);
+		if (ok && (c->edge_num < 0 || c->edge_num > 2*user_edge_num)) ok = false;
+		if (ok)
+		{
+			c->mapping = new int[c->edge_num];
+			c->ends = new NodeId[2*(long)c->edge_num];
+			c->weights = new int[(long)c->edge_num + node_num];
+			c->incoming = new int[node_num];
+			read(c->mapping, sizeof(int), c->edge_num);
+			read(c->ends, sizeof(NodeId), 2*(long)c->edge_num);
+			read(c->weights, sizeof(int), (long)c->edge_num + node_num);
+			read(c->incoming, sizeof(int), node_num);
+			read(&c->k_current, sizeof(int), 1);
+			read(&c->forest_num, sizeof(int), 1);
+		}
+		if (ok && (c->forest_num < 0 || c->forest_num > c->k_current)) ok = false;
+		if (ok)
+		{
+			c->parents = new EdgeId[(long)c->forest_num*(node_num+1)];
+			read(c->parents, sizeof(EdgeId), (long)c->forest_num*(node_num+1));
+		}
+		if (ok)
+		{
+			long e_max = (long)c->edge_num + node_num;
+			ok = parlay::all_of(parlay::make_slice(c->mapping, c->mapping + c->edge_num), [&] (int k) { return k >= 0 && k < user_edge_num; })
+			  && parlay::all_of(parlay::make_slice(c->ends, c->ends + 2*(long)c->edge_num), [&] (NodeId i) { return i >= 0 && i < node_num; })
+			  && parlay::all_of(parlay::make_slice(c->parents, c->parents + (long)c->forest_num*(node_num+1)), [&] (EdgeId e) { return e >= -1 && e < e_max; });
+		}
+	}
+	fclose(fp);
+	if (!ok)
+	{
+		fprintf(stderr, "Checkpoint %s is truncated or corrupt, ignored\n", checkpoint_file);
+		delete c;
+		return;
+	}
+	resumed = c;
+}
+
+void UndirectedGraph::WriteCheckpoint(CheckpointStage stage, int k_current)
+{
+	if (!checkpoint_file) return;
+	std::string tmp = std::string(checkpoint_file) + ".tmp";
+	FILE* fp = fopen(tmp.c_str(), "wb");
+	if (!fp) { fprintf(stderr, "Cannot write checkpoint %s\n", tmp.c_str()); return; }
+	bool ok = true;
+	auto write = [&] (const void* p, size_t size, long count) { if (ok && count > 0 && fwrite(p, size, count, fp) != (size_t)count) ok = false; };
+
+	int s = stage, f;
+	write(checkpoint_magic, 1, 8);
+	write(&s, sizeof(int), 1);
+	write(&checkpoint_hash, sizeof(checkpoint_hash), 1);
+	write(&node_num, sizeof(int), 1);
+	write(&user_edge_num, sizeof(int), 1);
+	write(&k0_lower, sizeof(int), 1);
+	write(&k0_upper, sizeof(int), 1);
+	if (stage == CHECKPOINT_FLOW)
+	{
+		auto weights = parlay::tabulate(2*(long)user_edge_num, [&] (long e) { return edges[e].weight; });
+		write(weights.data(), sizeof(int), weights.size());
+	}
+	if (stage == CHECKPOINT_FORESTS)
+	{
+		auto ends = parlay::tabulate(2*(long)edge_num, [&] (long a) { return edges[a/2].i[a & 1]; });
+		auto weights = parlay::tabulate((long)edge_num + node_num, [&] (long e) { return edges[e].weight; });
+		auto incoming = parlay::tabulate(node_num, [&] (NodeId i) { return nodes[i].incoming; });
+		write(&edge_num, sizeof(int), 1);
+		write(compacting_mapping, sizeof(int), edge_num);
+		write(ends.data(), sizeof(NodeId), ends.size());
+		write(weights.data(), sizeof(int), weights.size());
+		write(incoming.data(), sizeof(int), incoming.size());
+		write(&k_current, sizeof(int), 1);
+		write(&forest_num, sizeof(int), 1);
+		for (f=0; f<forest_num; f++)
+		{
+			forests[f]->UpdateParents();
+			write(forests[f]->parents, sizeof(EdgeId), node_num+1);
+		}
+	}
+	if (fclose(fp) != 0) ok = false;
+	if (!ok || rename(tmp.c_str(), checkpoint_file) != 0)
+	{
+		fprintf(stderr, "Cannot write checkpoint %s\n", checkpoint_file);
+		remove(tmp.c_str());
+	}
+	checkpoint_last = GetTime();
+}
+
+int UndirectedGraph::RestoreFlow()
+{
+	if (!resumed) return -1;
+	Checkpoint* c = resumed;
+	if (c->stage == CHECKPOINT_BRACKET)
+	{
+		k0_lower = std::max(k0_lower, c->k0_lower);
+		k0_upper = std::min(k0_upper, c->k0_upper);
+		delete resumed;
+		resumed = NULL;
+		return -1;
+	}
+	k0_lower = k0_upper = c->k0_lower;
+	if (c->stage == CHECKPOINT_FLOW)
+	{
+		parlay::parallel_for(0, 2*(long)user_edge_num, [&] (long e) { edges[e].weight = c->weights[e]; });
+		delete resumed;
+		resumed = NULL;
+	}
+	return k0_lower;
+}
+
+void UndirectedGraph::RestoreCompacted()
+{
+	Checkpoint* c = resumed;
+	EdgeId e;
+
+	assert(!compacting_mapping && c->stage == CHECKPOINT_FORESTS);
+
+	edge_num = c->edge_num;
+	compacting_mapping = new int[edge_num];
+	for (e=0; e<edge_num; e++)
+	{
+		compacting_mapping[e] = c->mapping[e];
+		edges[e].i[0] = c->ends[2*e];
+		edges[e].i[1] = c->ends[2*e+1];
+		edges[e].weight = c->weights[e];
+		edges[e].next_incoming = nodes[edges[e].i[1]].first_incoming;
+		nodes[edges[e].i[1]].first_incoming = e;
+	}
+}
+
+bool UndirectedGraph::RestoreForests(int* k_current)
+{
+	if (!resumed || resumed->stage != CHECKPOINT_FORESTS) return false;
+	Checkpoint* c = resumed;
+	int f;
+
+	*k_current = std::max(*k_current, c->k_current);
+	forests = new SpanningForest*[*k_current];
+	parlay::parallel_for(0, (long)edge_num + node_num, [&] (long e) { edges[e].weight = c->weights[e]; });
+	parlay::parallel_for(0, node_num, [&] (NodeId i) { nodes[i].incoming = c->incoming[i]; });
+	for (f=0; f<c->forest_num; f++)
+	{
+		EdgeId* parents = parent_arena.Allocate();
+		if (forest_type == FOREST_LINK_CUT) forests[f] = new SpanningForest(node_num + 1, nodes, edges, parents, edge_num + node_num);
+		else                                forests[f] = new SpanningForest(node_num + 1, nodes, edges, parents);
+	}
+	parlay::parallel_for(0, c->forest_num, [&] (int f) {
+		EdgeId* P = c->parents + (long)f*(node_num+1);
+		auto list = parlay::filter(parlay::make_slice(P, P + node_num + 1), [] (EdgeId e) { return e >= 0; });
+		forests[f]->SetEdges(list.data(), (int)list.size());
+	}, 1);
+	forest_num = c->forest_num;
+
+	delete resumed;
+	resumed = NULL;
+	return true;
+}
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+#include "approximate.h"
+#include "concurrent_union_find.h"
+
+void UndirectedGraph::ComputeOrientation()
+{
+	if (orientation) return;
+	orientation = new ApproximateArboricity;
+	orientation->Compute(node_num, user_edge_num, [&] (long k) { return std::make_tuple(edges[2*k].i[0], edges[2*k].i[1], edges[2*k].weight); }, 0);
+}
+
+UndirectedGraph* UndirectedGraph::NewSubproblem(int sub_node_num, const EdgeId* sub_edges, long sub_edge_num, const NodeId* local, const char* name)
+{
+	UndirectedGraph* g = new UndirectedGraph(sub_node_num, (int)sub_edge_num);
+	for (long p=0; p<sub_edge_num; p++)
+	{
+		Edge* e = &edges[2*sub_edges[p]];
+		g->AddEdge(local[e->i[0]], local[e->i[1]], e->weight);
+	}
+	g->SetTimeBudget(TimeLeft());
+	g->SetMaxflowBackend(maxflow_backend);
+	g->SetParallelProbes(probe_num);
+	g->SetSpanningForestType(forest_type);
+	g->SetComponentSolving(component_solving);
+	g->SetCorePruning(core_pruning);
+	g->SetGreedyForests(greedy_forests);
+	g->SetOrientationRefinement(orientation_refinement, refinement_iterations);
+	g->SetDensestSubgraph(densest_subgraph);
+	g->SetStats(stats != NULL);
+	if (checkpoint_file) g->SetCheckpoint((std::string(checkpoint_file) + "." + name).c_str(), checkpoint_interval, checkpoint_resume);
+	return g;
+}
+
+UndirectedGraph::EdgeId* UndirectedGraph::GetSubproblemForests(UndirectedGraph* g, const EdgeId* sub_edges)
+{
+	int n = g->node_num;
+	EdgeId* F = new EdgeId[(long)g->forest_num*n];
+	for (int f=0; f<g->forest_num; f++)
+	{
+		EdgeId* P = F + (long)f*n;
+		g->GetForestEdges(f, P);
+		parlay::parallel_for(0, n, [&] (int i) { if (P[i] >= 0) P[i] = sub_edges[P[i]]; });
+	}
+	return F;
+}
+
+void UndirectedGraph::AllocateUserParents()
+{
+	user_parents = new EdgeId[(long)forest_num*node_num];
+	parlay::parallel_for(0, (long)forest_num*node_num, [&] (long p) { user_parents[p] = -1; });
+}
+
+void UndirectedGraph::SetSubproblemForests(const EdgeId* F, int k, int sub_node_num, const NodeId* sub_nodes)
+{
+	parlay::parallel_for(0, (long)k*sub_node_num, [&] (long p) {
+		user_parents[(p/sub_node_num)*node_num + sub_nodes[p%sub_node_num]] = F[p];
+	});
+}
+
+void UndirectedGraph::SetOrientationForests(const EdgeId* user_edges, long num)
+{
+	// the out-edges of a node are in distinct forests, and the orientation is acyclic
+	parlay::parallel_for(0, num, [&] (long p) {
+		EdgeId k = user_edges[p];
+		NodeId i = orientation->tail[k];
+		for (int f=orientation->forest[k]; f<orientation->forest[k]+edges[2*k].weight; f++) user_parents[(long)f*node_num + i] = k;
+	});
+}
+
+// The arboricity is the maximum over the connected components. Every component c gets the bracket
+//   lower_c = ceil(m_c/(n_c-1)) <= arboricity_c <= upper_c = max out-degree of the degeneracy orientation within c.
+// Components are solved exactly in order of decreasing upper_c, num_workers() at a time, as long as upper_c exceeds the best
+// lower bound so far; the remaining ones are covered by the forests of ApproximateArboricity, which use at most upper_c forests.
+int UndirectedGraph::SolveComponents()
+{
+	int n = node_num;
+	auto positive = parlay::filter(parlay::iota<EdgeId>(user_edge_num), [&] (EdgeId k) { return edges[2*k].weight > 0; });
+	if (positive.size() == 0) return -2; // nothing to split (and parlay::histogram_by_index() divides by zero on an empty input)
+
+	ConcurrentUnionFind U(n);
+	parlay::for_each(positive, [&] (EdgeId k) { U.Unite(edges[2*k].i[0], edges[2*k].i[1]); });
+	auto root = parlay::tabulate(n, [&] (NodeId i) { return U.Find(i); });
+
+	auto degree = parlay::histogram_by_index(parlay::delayed_tabulate(2*positive.size(), [&] (size_t a) {
+		return edges[2*positive[a/2]].i[a & 1];
+	}), (size_t)n);
+	auto active = parlay::filter(parlay::iota<NodeId>(n), [&] (NodeId i) { return degree[i] > 0; });
+	auto comp_roots = parlay::filter(active, [&] (NodeId i) { return root[i] == i; });
+	int comp_num = (int)comp_roots.size();
+	if (comp_num <= 1) return -2;
+
+	// nodes and edges grouped by component, in increasing id order within a component
+	auto comp = parlay::sequence<int>(n, -1);
+	parlay::parallel_for(0, comp_num, [&] (int c) { comp[comp_roots[c]] = c; });
+	auto node_comp = [&] (NodeId i) { return comp[root[i]]; };
+	auto edge_comp = [&] (EdgeId k) { return comp[root[edges[2*k].i[0]]]; };
+	auto comp_nodes = parlay::integer_sort(active, [&] (NodeId i) { return (unsigned)node_comp(i); });
+	auto comp_edges = parlay::integer_sort(positive, [&] (EdgeId k) { return (unsigned)edge_comp(k); });
+	auto [node_first, node_total] = parlay::scan(parlay::histogram_by_index(parlay::delayed_map(active, node_comp), (size_t)comp_num));
+	auto [edge_first, edge_total] = parlay::scan(parlay::histogram_by_index(parlay::delayed_map(positive, edge_comp), (size_t)comp_num));
+	node_first.push_back(node_total);
+	edge_first.push_back(edge_total);
+	auto local = parlay::sequence<NodeId>(n, -1);
+	parlay::parallel_for(0, comp_nodes.size(), [&] (size_t p) {
+		NodeId i = comp_nodes[p];
+		local[i] = (NodeId)(p - node_first[node_comp(i)]);
+	});
+
+	ComputeOrientation();
+	ApproximateArboricity& A = *orientation;
+	if (densest_subgraph) DensestFromOrientation();
+
+	auto comp_lower = parlay::tabulate(comp_num, [&] (int c) {
+		long n_c = node_first[c+1] - node_first[c];
+		long m_c = parlay::reduce(parlay::delayed_tabulate(edge_first[c+1] - edge_first[c], [&] (long p) {
+			return (long)edges[2*comp_edges[edge_first[c] + p]].weight;
+		}));
+		return (int)((m_c + n_c - 2) / (n_c - 1));
+	});
+	auto comp_upper = parlay::tabulate(comp_num, [&] (int c) {
+		return parlay::reduce(parlay::delayed_tabulate(edge_first[c+1] - edge_first[c], [&] (long p) {
+			EdgeId k = comp_edges[edge_first[c] + p];
+			return A.forest[k] + edges[2*k].weight;
+		}), parlay::maximum<int>());
+	});
+	int lower = std::max(A.lower, parlay::reduce(comp_lower, parlay::maximum<int>()));
+
+	// candidates for an exact solve, by decreasing upper bound (and then by decreasing size)
+	auto order = parlay::sort(parlay::iota<int>(comp_num), [&] (int c, int d) {
+		if (comp_upper[c] != comp_upper[d]) return comp_upper[c] > comp_upper[d];
+		long m_c = edge_first[c+1] - edge_first[c], m_d = edge_first[d+1] - edge_first[d];
+		return (m_c != m_d) ? (m_c > m_d) : (c < d);
+	});
+	auto comp_k = parlay::sequence<int>(comp_num, -1); // -1: covered by A
+	auto comp_bracket = parlay::sequence<std::pair<int,int>>(comp_num); // of the components that ran out of time
+	auto comp_forests = parlay::sequence<EdgeId*>(comp_num, NULL); // comp_k[c] arrays of size n_c with the parent edges (user ids)
+	auto comp_densest = parlay::sequence<parlay::sequence<NodeId>>(comp_num); // the witnesses of the components, see SetDensestSubgraph()
+	auto comp_densest_weight = parlay::sequence<long>(comp_num, 0);
+	std::vector<SolveStats> comp_stats((stats) ? comp_num : 0);
+	bool out_of_time = false;
+	size_t next = 0;
+
+	while (next < order.size() && comp_upper[order[next]] > lower)
+	{
+		if (TimeBudgetExceeded()) { out_of_time = true; break; }
+
+		size_t end = next;
+		while (end < order.size() && end - next < parlay::num_workers() && comp_upper[order[end]] > lower) end ++;
+
+		parlay::parallel_for(next, end, [&] (size_t q) {
+			int c = order[q];
+			UndirectedGraph* g = NewSubproblem((int)(node_first[c+1] - node_first[c]), comp_edges.data() + edge_first[c], edge_first[c+1] - edge_first[c], local.data(),
+			                                   ("c" + std::to_string(c)).c_str());
+			g->SetComponentSolving(false);
+
+			int k = g->Solve();
+			if (stats) comp_stats[c] = *g->GetStats();
+			if (g->densest)
+			{
+				comp_densest[c] = parlay::tabulate(g->densest_num, [&] (int l) { return comp_nodes[node_first[c] + g->densest[l]]; });
+				comp_densest_weight[c] = g->densest_weight;
+			}
+			if (k < 0)
+			{
+				g->GetBounds(&comp_bracket[c].first, &comp_bracket[c].second);
+				comp_k[c] = -2;
+			}
+			else
+			{
+				comp_forests[c] = GetSubproblemForests(g, comp_edges.data() + edge_first[c]);
+				comp_k[c] = k;
+			}
+			delete g;
+		}, 1);
+
+		for (size_t q=next; q<end; q++)
+		{
+			int c = order[q];
+			if (stats) stats->Add(comp_stats[c]);
+			SetDensest(comp_densest[c].data(), (int)comp_densest[c].size(), comp_densest_weight[c]);
+			if (comp_k[c] >= 0) lower = std::max(lower, comp_k[c]);
+			else                { lower = std::max(lower, comp_bracket[c].first); out_of_time = true; }
+		}
+		next = end;
+		if (out_of_time) break;
+	}
+
+	if (out_of_time)
+	{
+		// every component that was not solved may still have the largest arboricity
+		int upper = lower;
+		for (int c=0; c<comp_num; c++)
+		{
+			if (comp_k[c] == -2)     upper = std::max(upper, comp_bracket[c].second);
+			else if (comp_k[c] < 0) upper = std::max(upper, comp_upper[c]);
+			if (comp_forests[c]) delete [] comp_forests[c];
+		}
+		arboricity_lower = lower;
+		arboricity_upper = upper;
+		return -1;
+	}
+
+	// lower is attained: either by a solved component, or it bounds all the others and is itself a lower bound
+	forest_num = lower;
+	AllocateUserParents();
+	parlay::parallel_for(0, comp_num, [&] (int c) {
+		if (comp_k[c] >= 0)
+		{
+			SetSubproblemForests(comp_forests[c], comp_k[c], (int)(node_first[c+1] - node_first[c]), comp_nodes.data() + node_first[c]);
+			delete [] comp_forests[c];
+		}
+		else SetOrientationForests(comp_edges.data() + edge_first[c], edge_first[c+1] - edge_first[c]);
+	}, 1);
+
+	arboricity_lower = arboricity_upper = forest_num;
+	return forest_num;
+}
@@ -0,0 +1,45 @@
+#ifndef __CONCURRENT_UNION_FIND_H__
+#define __CONCURRENT_UNION_FIND_H__
+
+#include <atomic>
+#include <utility>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Concurrent union-find. A root is only linked (with a CAS) below a node with a smaller id, so concurrent unions
+// cannot create cycles, and the root of every component is its smallest node.
+// (parlaylib/examples/helper/union_find.h leaves it to the caller to avoid concurrent links of the same root.)
+struct ConcurrentUnionFind
+{
+	ConcurrentUnionFind(int n) : parents(parlay::tabulate<std::atomic<int>>(n, [] (long) { return -1; })) {}
+
+	int Find(int i)
+	{
+		while ( 1 )
+		{
+			int p = parents[i].load();
+			if (p < 0) return i;
+			int gp = parents[p].load();
+			if (gp >= 0) parents[i].compare_exchange_weak(p, gp); // path halving
+			i = p;
+		}
+	}
+	void Unite(int u, int v)
+	{
+		while ( 1 )
+		{
+			u = Find(u);
+			v = Find(v);
+			if (u == v) return;
+			if (u < v) std::swap(u, v);
+			int expected = -1;
+			if (parents[u].compare_exchange_strong(expected, v)) return;
+		}
+	}
+	void Link(int u, int v) { parents[u] = v; } // u must be a root and v < u, with no concurrent Unite() of u
+	void Reset() { parlay::parallel_for(0, parents.size(), [&] (size_t i) { parents[i] = -1; }); }
+
+	parlay::sequence<std::atomic<int>> parents;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+#include "approximate.h"
+
+// Let L <= arboricity be the lower bound from the core decomposition, and r0 the first peeling round with a node
+// of (weighted) out-degree > L. The nodes of the rounds >= r0 form a subgraph S of the (L+1)-core, and every edge with an
+// endpoint outside S is oriented away from a node of out-degree <= L. Adding these nodes to forests of S in reverse peeling
+// order, each with at most one edge per forest towards a node that is already there, keeps the forests acyclic, hence
+//   arboricity = max(arboricity(S), L).
+// Only S is solved exactly.
+int UndirectedGraph::SolveCore()
+{
+	if (user_edge_num == 0) return -2; // parlay::reduce_by_index() divides by zero on an empty input
+	ComputeOrientation();
+	ApproximateArboricity& A = *orientation;
+	int L = A.lower;
+
+	auto out_degree = parlay::reduce_by_index(parlay::delayed_tabulate(user_edge_num, [&] (EdgeId k) {
+		return std::make_pair(A.tail[k], (long)edges[2*k].weight);
+	}), node_num);
+	// S is empty if the orientation already gives L forests
+	int r0 = parlay::reduce(parlay::delayed_tabulate(node_num, [&] (NodeId i) {
+		return (out_degree[i] > L) ? A.round[i] : A.round_num;
+	}), parlay::minimum<int>());
+
+	auto positive = parlay::filter(parlay::iota<EdgeId>(user_edge_num), [&] (EdgeId k) { return edges[2*k].weight > 0; });
+	auto in_core = [&] (EdgeId k) { return A.round[A.tail[k]] >= r0; };
+	auto sub_edges = parlay::filter(positive, in_core);
+	// not worth a copy of the graph if little is removed
+	if (sub_edges.size() > 0 && 8*(positive.size() - sub_edges.size()) < positive.size()) return -2;
+	auto peeled_edges = parlay::filter(positive, [&] (EdgeId k) { return !in_core(k); });
+	if (densest_subgraph) DensestFromOrientation();
+
+	int k = 0;
+	EdgeId* F = NULL;
+	auto sub_nodes = parlay::filter(parlay::iota<NodeId>(node_num), [&] (NodeId i) { return A.round[i] >= r0; });
+	if (sub_edges.size() > 0)
+	{
+		auto local = parlay::sequence<NodeId>(node_num, -1);
+		parlay::parallel_for(0, sub_nodes.size(), [&] (size_t l) { local[sub_nodes[l]] = (NodeId)l; });
+
+		UndirectedGraph* g = NewSubproblem((int)sub_nodes.size(), sub_edges.data(), sub_edges.size(), local.data(), "core");
+		g->SetCorePruning(false);
+		k = g->Solve();
+		if (stats) stats->Add(*g->GetStats());
+		TakeSubproblemDensest(g, sub_nodes.data());
+		if (k < 0)
+		{
+			int lower, upper;
+			g->GetBounds(&lower, &upper);
+			delete g;
+			arboricity_lower = std::max(L, lower);
+			arboricity_upper = std::min(A.upper, std::max(L, upper));
+			return -1;
+		}
+		F = GetSubproblemForests(g, sub_edges.data());
+		delete g;
+	}
+
+	forest_num = std::max(k, L);
+	AllocateUserParents();
+	if (F)
+	{
+		SetSubproblemForests(F, k, (int)sub_nodes.size(), sub_nodes.data());
+		delete [] F;
+	}
+	SetOrientationForests(peeled_edges.data(), peeled_edges.size());
+
+	arboricity_lower = arboricity_upper = forest_num;
+	return forest_num;
+}
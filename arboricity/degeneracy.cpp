@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <utility>
+#include "degeneracy.h"
+
+int ComputeCoreness(const Adjacency& G, parlay::sequence<int>& d, parlay::sequence<int>* round)
+{
+	int n = G.node_num;
+	d = parlay::tabulate(n, [&] (int v) {
+		return (int)parlay::reduce(parlay::make_slice(G.weights.begin() + G.Begin(v), G.weights.begin() + G.End(v)));
+	});
+	if (round) *round = parlay::sequence<int>(n, 0);
+	if (n == 0) return 0;
+
+	auto done = parlay::sequence<bool>(n, false);
+	int maxd = parlay::reduce(d, parlay::maximum<int>()) + 1;
+	auto di = parlay::delayed_tabulate(n, [&] (int v) { return std::pair(d[v], v); });
+	auto buckets = parlay::map(parlay::group_by_index(di, maxd), [] (auto& b) {
+		return parlay::sequence<parlay::sequence<int>>(1, b);
+	});
+	int k = 0, degeneracy = 0, r = 0;
+	long total = 0;
+
+	while (total < n)
+	{
+		auto b = parlay::filter(parlay::flatten(buckets[k]), [&] (int v) { return done[v] ? false : (done[v] = true); });
+		buckets[k].clear();
+		if (b.size() == 0) { k ++; continue; }
+		total += b.size();
+		degeneracy = k;
+		if (round) parlay::for_each(b, [&] (int v) { (*round)[v] = r; });
+		r ++;
+
+		// weighted number of removed edges per surviving neighbour
+		auto ngh = parlay::filter(parlay::flatten(parlay::map(b, [&] (int v) {
+			return parlay::delayed_tabulate(G.End(v) - G.Begin(v), [&, v] (long a) {
+				return std::pair(G.targets[G.Begin(v) + a], G.weights[G.Begin(v) + a]);
+			});
+		})), [&] (const std::pair<int,int>& uw) { return d[uw.first] > k; });
+		auto u = parlay::map(parlay::reduce_by_key(ngh), [&] (const std::pair<int,int>& uc) {
+			auto [u, c] = uc;
+			d[u] = std::max(k, d[u] - c);
+			return std::pair(d[u], u);
+		});
+		parlay::for_each(parlay::group_by_key_ordered(u), [&] (auto& dv) {
+			auto& [du, v] = dv;
+			buckets[du].push_back(std::move(v));
+		});
+	}
+	return degeneracy;
+}
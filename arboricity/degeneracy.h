@@ -0,0 +1,57 @@
+#ifndef __DEGENERACY_H__
+#define __DEGENERACY_H__
+
+#include <tuple>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Weighted adjacency lists in CSR form. The neighbours of v are targets[offsets[v]..offsets[v+1]),
+// an edge of weight w is listed (with weight w) in the lists of both of its endpoints.
+struct Adjacency
+{
+	int node_num;
+	parlay::sequence<long> offsets; // of size node_num+1
+	parlay::sequence<int> targets;
+	parlay::sequence<int> weights;
+
+	// edge(k) for k\in[0,edge_num-1] must return std::tuple<int,int,int> (i, j, weight). Zero-weight edges are skipped.
+	template <class F> void Build(int node_num, long edge_num, F edge);
+
+	long Begin(int v) const { return offsets[v]; }
+	long End(int v) const { return offsets[v+1]; }
+};
+
+// Computes the coreness of every node by parallel bucketed peeling (a weighted version of
+// parlaylib/examples/kcore.h); an edge of weight w counts as w parallel edges.
+// Returns the degeneracy, i.e. the largest coreness.
+// If round is not NULL, (*round)[v] receives the peeling round in which v was removed. Orienting every edge towards
+// the endpoint removed later (ties broken by node id) gives an acyclic orientation with out-degree at most the degeneracy.
+int ComputeCoreness(const Adjacency& G, parlay::sequence<int>& coreness, parlay::sequence<int>* round = NULL);
+
+template <class F> void Adjacency::Build(int _node_num, long edge_num, F edge)
+{
+	node_num = _node_num;
+
+	auto arcs = parlay::filter(parlay::delayed_tabulate(2*edge_num, [&] (long a) {
+		auto [i, j, w] = edge(a/2);
+		return (a & 1) ? std::make_tuple(j, i, w) : std::make_tuple(i, j, w);
+	}), [] (const std::tuple<int,int,int>& a) { return std::get<2>(a) > 0; });
+	arcs = parlay::integer_sort(arcs, [] (const std::tuple<int,int,int>& a) { return (unsigned)std::get<0>(a); });
+
+	if (arcs.empty()) // parlay::histogram_by_index() divides by zero on an empty input
+	{
+		offsets = parlay::sequence<long>(node_num+1, 0L);
+		targets.clear();
+		weights.clear();
+		return;
+	}
+	auto counts = parlay::histogram_by_index(parlay::delayed_map(arcs, [] (const std::tuple<int,int,int>& a) { return std::get<0>(a); }), (long)node_num);
+	long total;
+	std::tie(offsets, total) = parlay::scan(counts);
+	offsets.push_back(total);
+
+	targets = parlay::map(arcs, [] (const std::tuple<int,int,int>& a) { return std::get<1>(a); });
+	weights = parlay::map(arcs, [] (const std::tuple<int,int,int>& a) { return std::get<2>(a); });
+}
+
+#endif
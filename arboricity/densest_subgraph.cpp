@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <tuple>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+#include "approximate.h"
+#include "densest_subgraph.h"
+
+// The max-flow network of Solve0() at k has a flow saturating all source arcs iff some orientation has max-indegree <= k.
+// If it does not, let S be the vertices reachable from the source in the residual network. An edge node reachable from the
+// source has both of its endpoints in S (its arcs to them have infinite capacity), and the cut around S has the capacity of
+// the max-flow, which is below the total weight W. That is W - (weight of the reachable edge nodes) + k*|S| < W, so the
+// edges within S weigh more than k*|S|. At k = k0-1 this certifies k0 = ceil(max_S' m(S')/|S'|).
+
+int UndirectedGraph::GetDensestSubgraph(NodeId* S)
+{
+	if (!densest) return 0;
+	parlay::parallel_for(0, densest_num, [&] (int p) { S[p] = densest[p]; });
+	return densest_num;
+}
+
+void UndirectedGraph::SetDensest(const NodeId* S, int num, long weight)
+{
+	if (num == 0 || weight == 0) return;
+	if (densest && (double)weight*densest_num <= (double)densest_weight*num) return;
+	if (densest) delete [] densest;
+	densest = new NodeId[num];
+	parlay::parallel_for(0, num, [&] (int p) { densest[p] = S[p]; });
+	densest_num = num;
+	densest_weight = weight;
+}
+
+void UndirectedGraph::RecordDensest(ArboricityMaxflow* g, const int* weights)
+{
+	auto side = parlay::sequence<char>(node_num);
+	g->GetSourceSide(side.data());
+	auto S = parlay::filter(parlay::iota<NodeId>(node_num), [&] (NodeId i) { return side[i] != 0; });
+	long weight = InducedWeight(node_num, user_edge_num, [&] (long e) {
+		return std::make_tuple(edges[2*e].i[0], edges[2*e].i[1], weights[e]);
+	}, S.data(), S.size());
+	SetDensest(S.data(), (int)S.size(), weight);
+}
+
+void UndirectedGraph::ComputeDensest(int k0, bool split)
+{
+	if (!densest_subgraph || densest || k0 <= 0) return;
+	auto ends = parlay::tabulate(user_edge_num, [&] (EdgeId e) { return std::make_pair(edges[2*e].i[0], edges[2*e].i[1]); });
+	auto weights = parlay::tabulate(user_edge_num, [&] (EdgeId e) { return edges[2*e].weight + ((split) ? edges[2*e+1].weight : 0); });
+	ArboricityMaxflow* g = NewArboricityMaxflow(maxflow_backend, node_num, user_edge_num, ends.data(), weights.data());
+	g->SetSinkCapacity(k0-1);
+	g->Maxflow(false);
+	RecordDensest(g, weights.data());
+	delete g;
+}
+
+// The cores are the suffixes of the degeneracy ordering, and every edge is in the suffixes that contain its tail.
+void UndirectedGraph::DensestFromOrientation()
+{
+	ApproximateArboricity& A = *orientation;
+	int R = A.round_num;
+	if (R == 0) return;
+	auto round_nodes = parlay::histogram_by_index(A.round, (long)R);
+	auto round_weight = parlay::reduce_by_index(parlay::delayed_tabulate(user_edge_num, [&] (EdgeId e) {
+		return std::make_pair(A.round[A.tail[e]], (long)edges[2*e].weight);
+	}), R);
+
+	int best = -1;
+	long n_r = 0, m_r = 0, n_best = 0, m_best = 0;
+	for (int r=R-1; r>=0; r--)
+	{
+		n_r += round_nodes[r];
+		m_r += round_weight[r];
+		if (n_r > 0 && (best < 0 || (double)m_r*n_best > (double)m_best*n_r)) { best = r; n_best = n_r; m_best = m_r; }
+	}
+	if (best < 0) return;
+	auto S = parlay::filter(parlay::iota<NodeId>(node_num), [&] (NodeId i) { return A.round[i] >= best; });
+	SetDensest(S.data(), (int)S.size(), m_best);
+}
+
+void UndirectedGraph::TakeSubproblemDensest(UndirectedGraph* g, const NodeId* sub_nodes)
+{
+	if (!g->densest) return;
+	auto S = parlay::tabulate(g->densest_num, [&] (int l) { return sub_nodes[g->densest[l]]; });
+	SetDensest(S.data(), g->densest_num, g->densest_weight);
+}
@@ -0,0 +1,26 @@
+#ifndef __DENSEST_SUBGRAPH_H__
+#define __DENSEST_SUBGRAPH_H__
+
+#include <atomic>
+#include <tuple>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Parallel check of a dense subgraph, e.g. the witness of UndirectedGraph::GetDensestSubgraph(), against the input graph.
+// edge(k) for k\in[0,edge_num-1] must return std::tuple<int,int,int> (i, j, weight), as in ApproximateArboricity::Compute().
+// Returns m(S), the total weight of the edges with both endpoints in S = {S[0],...,S[num-1]}, so that the density of S is
+// m(S)/num; or -1 if S has a node outside [0,node_num-1] or a repeated node.
+template <class F> long InducedWeight(int node_num, long edge_num, F edge, const int* S, long num)
+{
+	auto in_S = parlay::tabulate<std::atomic<bool>>(node_num, [] (long) { return false; });
+	bool ok = parlay::all_of(parlay::make_slice(S, S + num), [&] (int i) {
+		return i >= 0 && i < node_num && !in_S[i].exchange(true);
+	});
+	if (!ok) return -1;
+	return parlay::reduce(parlay::delayed_tabulate(edge_num, [&] (long k) {
+		auto [i, j, w] = edge(k);
+		return (in_S[i].load() && in_S[j].load()) ? (long)w : 0L;
+	}));
+}
+
+#endif
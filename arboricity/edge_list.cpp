@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <optional>
+#include <parlay/primitives.h>
+#include "edge_list.h"
+
+#define LINE_EDGE      0
+#define LINE_SKIP      1
+#define LINE_MALFORMED 2
+
+struct ParsedLine
+{
+	int status; // LINE_EDGE, LINE_SKIP or LINE_MALFORMED
+	int a, b;
+};
+
+static bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static bool ParseId(const char*& p, const char* end, int& x)
+{
+	long v = 0;
+	const char* start = p;
+	while (p < end && *p >= '0' && *p <= '9')
+	{
+		v = 10*v + (*p ++ - '0');
+		if (v > 0x7fffffffL) return false;
+	}
+	x = (int)v;
+	return p > start;
+}
+
+static ParsedLine ParseLine(const char* p, const char* end)
+{
+	ParsedLine L;
+	while (p < end && IsBlank(*p)) p ++;
+	if (p == end || *p == '#' || *p == '%') { L.status = LINE_SKIP; return L; }
+
+	L.status = LINE_MALFORMED;
+	if (!ParseId(p, end, L.a)) return L;
+	if (p == end || !IsBlank(*p)) return L;
+	while (p < end && IsBlank(*p)) p ++;
+	if (!ParseId(p, end, L.b)) return L;
+	if (p < end && !IsBlank(*p)) return L;
+	L.status = LINE_EDGE;
+	return L;
+}
+
+// the lines of data[0..n-1], parsed in parallel; line k spans [line_start(k), line_ends[k])
+static parlay::sequence<ParsedLine> ParseLines(const char* data, size_t n)
+{
+	auto line_ends = parlay::pack_index<long>(parlay::delayed_tabulate(n, [&] (size_t i) { return data[i] == '\n'; }));
+	if (n > 0 && data[n-1] != '\n') line_ends.push_back((long)n);
+	return parlay::tabulate(line_ends.size(), [&] (size_t k) {
+		long start = (k == 0) ? 0 : line_ends[k-1] + 1;
+		return ParseLine(data + start, data + line_ends[k]);
+	});
+}
+
+bool EdgeList::Load(const char* filename)
+{
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) return false;
+	struct stat sb;
+	if (fstat(fd, &sb) < 0 || !S_ISREG(sb.st_mode)) { close(fd); return false; }
+
+	size_t n = (size_t)sb.st_size;
+	const char* data = NULL;
+	if (n > 0)
+	{
+		void* p = mmap(NULL, n, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) { close(fd); return false; }
+		madvise(p, n, MADV_SEQUENTIAL);
+		data = (const char*)p;
+	}
+	close(fd);
+
+	auto lines = ParseLines(data, n);
+	if (data) munmap((void*)data, n);
+
+	malformed_lines = parlay::count_if(lines, [] (const ParsedLine& L) { return L.status == LINE_MALFORMED; });
+	self_loops = parlay::count_if(lines, [] (const ParsedLine& L) { return L.status == LINE_EDGE && L.a == L.b; });
+
+	// normalise to (min,max) and pack into 64-bit keys, so that dedup is a single integer sort + unique
+	auto keys = parlay::map_maybe(lines, [] (const ParsedLine& L) -> std::optional<unsigned long long> {
+		if (L.status != LINE_EDGE || L.a == L.b) return std::nullopt;
+		unsigned long long u = (unsigned)std::min(L.a, L.b), v = (unsigned)std::max(L.a, L.b);
+		return (u << 32) | v;
+	});
+	size_t key_num = keys.size();
+	keys = parlay::unique(parlay::integer_sort(keys));
+	duplicates = (long)(key_num - keys.size());
+
+	edges = parlay::map(keys, [] (unsigned long long x) { return Edge((int)(x >> 32), (int)(x & 0xffffffffULL)); });
+
+	// keys are sorted by the smaller endpoint, so the largest id is among the larger endpoints
+	node_num = (edges.size() == 0) ? 0 : 1 + parlay::reduce(parlay::delayed_map(edges, [] (const Edge& e) { return e.second; }), parlay::maximum<int>());
+
+	auto endpoints = parlay::delayed_tabulate(2*edges.size(), [&] (size_t k) { return (k & 1) ? edges[k/2].second : edges[k/2].first; });
+	if (edges.size() == 0) degrees = parlay::sequence<int>(); // parlay::histogram_by_index() divides by zero on an empty input
+	else degrees = parlay::histogram_by_index(endpoints, node_num);
+	max_degree = (node_num == 0) ? 0 : parlay::reduce(degrees, parlay::maximum<int>());
+	active_node_num = (int)parlay::count_if(degrees, [] (int d) { return d > 0; });
+
+	return true;
+}
+
+bool EdgeStream::Open(const char* filename, size_t block_size)
+{
+	Close();
+	fp = fopen(filename, "rb");
+	if (!fp) return false;
+	// no larger than the file, if its size is known
+	if (fseeko(fp, 0, SEEK_END) == 0)
+	{
+		off_t size = ftello(fp);
+		if (size >= 0) block_size = std::min(block_size, (size_t)size + 1);
+	}
+	buffer = parlay::sequence<char>(std::max(block_size, (size_t)1 << 16));
+	Rewind();
+	return true;
+}
+
+void EdgeStream::Close()
+{
+	if (fp) fclose(fp);
+	fp = NULL;
+}
+
+void EdgeStream::Rewind()
+{
+	clearerr(fp);
+	error = end_of_file = (fseeko(fp, 0, SEEK_SET) != 0); // e.g. a pipe
+	pending = 0;
+	malformed_lines = self_loops = edge_num = 0;
+}
+
+bool EdgeStream::Next(parlay::sequence<Edge>& block)
+{
+	block.clear();
+	while (!end_of_file)
+	{
+		// buffer[0..pending-1] is the unfinished last line of the previous read
+		if (pending == buffer.size()) buffer.resize(2*buffer.size()); // a line longer than the buffer
+		size_t got = fread(buffer.data() + pending, 1, buffer.size() - pending, fp);
+		if (got == 0)
+		{
+			if (ferror(fp)) error = true;
+			end_of_file = true;
+		}
+		size_t n = pending + got, complete = n;
+		if (!end_of_file)
+		{
+			while (complete > 0 && buffer[complete-1] != '\n') complete --;
+			if (complete == 0) { pending = n; continue; }
+		}
+
+		auto lines = ParseLines(buffer.data(), complete);
+		malformed_lines += parlay::count_if(lines, [] (const ParsedLine& L) { return L.status == LINE_MALFORMED; });
+		self_loops += parlay::count_if(lines, [] (const ParsedLine& L) { return L.status == LINE_EDGE && L.a == L.b; });
+		block = parlay::map_maybe(lines, [] (const ParsedLine& L) -> std::optional<Edge> {
+			if (L.status != LINE_EDGE || L.a == L.b) return std::nullopt;
+			return Edge(L.a, L.b);
+		});
+		edge_num += block.size();
+
+		pending = n - complete;
+		std::copy(buffer.begin() + complete, buffer.begin() + n, buffer.begin());
+		if (block.size() > 0) return true;
+	}
+	return false;
+}
@@ -0,0 +1,58 @@
+#ifndef __EDGE_LIST_H__
+#define __EDGE_LIST_H__
+
+#include <stdio.h>
+#include <utility>
+#include <parlay/sequence.h>
+
+// Parallel loader for whitespace-separated edge-list files ("a b" per line), shared by
+// find_arboricity and estimate_arboricity. Lines starting with '#' or '%' and empty lines are ignored.
+//
+// The file is mmap'ed and parsed line-by-line in parallel. Every pair is normalised to (min,max),
+// self-loops are dropped and duplicates (including reversed copies) are removed with a parallel sort + unique,
+// so the result can be passed directly to UndirectedGraph::AddEdges().
+struct EdgeList
+{
+	typedef std::pair<int,int> Edge;
+
+	EdgeList() : node_num(0), active_node_num(0), max_degree(0), malformed_lines(0), self_loops(0), duplicates(0) {}
+
+	bool Load(const char* filename); // returns false if the file cannot be read
+
+	parlay::sequence<Edge> edges; // sorted, edges[k].first < edges[k].second
+	parlay::sequence<int> degrees; // of size node_num
+
+	int node_num; // largest node id + 1
+	int active_node_num; // number of nodes with at least one incident edge
+	int max_degree;
+
+	long malformed_lines, self_loops, duplicates; // dropped while loading
+};
+
+// Reader for passes over an edge-list file that is too large to keep in memory (same format as EdgeList::Load()).
+// The file must be seekable, as every pass reads it from the start.
+// The file is read sequentially in blocks of about block_size bytes, and every block is parsed in parallel, so memory
+// is O(block_size) whatever the size of the file. Self-loops are dropped, but duplicates are not (that takes the whole edge set).
+struct EdgeStream
+{
+	typedef std::pair<int,int> Edge;
+
+	EdgeStream() : malformed_lines(0), self_loops(0), edge_num(0), fp(NULL) {}
+	~EdgeStream() { Close(); }
+
+	bool Open(const char* filename, size_t block_size = (size_t)64 << 20); // returns false if the file cannot be read
+	void Close();
+	void Rewind(); // starts a new pass
+	bool Next(parlay::sequence<Edge>& block); // the edges of the next block, in file order; returns false at the end of the pass
+	bool Failed() { return error; } // a read error occurred during the current pass
+
+	long malformed_lines, self_loops, edge_num; // counted by the current pass so far
+
+private:
+	FILE* fp;
+	size_t pending;
+	parlay::sequence<char> buffer;
+	bool end_of_file, error;
+};
+
+#endif
@@ -1,91 +1,115 @@
 #include <iostream>
-#include <fstream>
-#include <cmath>
-#include <vector>
 #include <string>
-#include <sstream>  
-#include <algorithm>
-#include <limits>
-#include <unordered_map>
-#include <unordered_set>
-#include <omp.h>
-#include <utility>
-#include <atomic>
-
-int find_largest_deg(const std::vector<std::pair<int,int>>& edges, int num_nodes);
-
-
-struct PairHash {
-    size_t operator()(const std::pair<int,int>& p) const noexcept {
-        // pack into 64 bits
-        return std::hash<long long>()(
-            (static_cast<long long>(p.first) << 32) ^ p.second
-        );
-    }
-};
+#include <stdio.h>
+#include <stdlib.h>
+#include "approximate.h"
+#include "edge_list.h"
+#include "stream_estimate.h"
 
 int main(int argc, char **argv) {
-    std::vector<std::pair<int, int>> edges;
-    std::unordered_set<std::pair<int,int>, PairHash> seen;
-    std::unordered_set<int> nodes;
-
-    std::string data_file  = argv[1];
-    std::ifstream input(data_file);
+    const char* data_file = NULL;
+    const char* cover_file = NULL;
+    double eps = 0;
+    double densest_eps = -1;
+    int densest_iterations = 100;
+    bool stream = false;
+    bool symmetric = false;
+    long block_mb = 64;
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (arg == "--eps" && a + 1 < argc) {
+            eps = atof(argv[++a]);
+        } else if (arg == "--densest" && a + 1 < argc) {
+            densest_eps = atof(argv[++a]);
+        } else if (arg == "--densest-iterations" && a + 1 < argc) {
+            densest_iterations = atoi(argv[++a]);
+        } else if (arg == "--cover" && a + 1 < argc) {
+            cover_file = argv[++a];
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--symmetric") {
+            symmetric = true;
+        } else if (arg == "--block" && a + 1 < argc) {
+            block_mb = atol(argv[++a]);
+        } else if (arg[0] != '-' && !data_file) {
+            data_file = argv[a];
+        } else {
+            std::cerr << "Unknown option or missing value: " << arg << "\n";
+            data_file = NULL;
+            break;
+        }
+    }
+    if (!data_file || (stream && (cover_file || densest_eps >= 0)) || block_mb <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [--eps EPS] [--densest EPS] [--densest-iterations N] [--cover FILE] <edge list file>\n";
+        std::cerr << "       " << argv[0] << " --stream [--eps EPS] [--symmetric] [--block MB] <edge list file>\n";
+        std::cerr << "  --eps 0 (default) orients along a degeneracy ordering, --eps > 0 peels in O(log(n)/eps) rounds\n";
+        std::cerr << "  --stream peels with O(n) memory, re-reading the file in blocks of MB megabytes (64 by default) every round\n";
+        std::cerr << "    instead of loading it (EPS 0.1 by default); the file must list every edge once, or both ways with --symmetric\n";
+        return 1;
+    }
 
-    size_t num_edges = 0;
-    size_t num_nodes;
+    if (stream) {
+        StreamingArboricity S;
+        if (!S.Compute(data_file, (eps > 0) ? eps : 0.1, symmetric, (size_t)block_mb << 20)) {
+            std::cerr << "Error reading " << data_file << "\n";
+            return 1;
+        }
+        if (S.malformed_lines > 0) {
+            std::cerr << "Skipped " << S.malformed_lines << " malformed lines\n";
+        }
+        std::cerr << "Passes " << S.pass_num << "\n";
+        std::cerr << "Densest subgraph density in [" << S.density_lower << "," << S.density_upper << "]\n";
+        if (S.lower == S.upper) {
+            std::cout << S.upper << std::endl;
+        } else {
+            std::cout << "[" << S.lower << "," << S.upper << "]" << std::endl;
+        }
+        std::cout << S.active_node_num << std::endl;
+        std::cout << S.edge_num << std::endl;
+        return 0;
+    }
 
-    if (!input) {
+    EdgeList list;
+    if (!list.Load(data_file)) {
 		std::cerr << "Error opening an input file.\n";
         return 1;
 	}
+    if (list.malformed_lines > 0) {
+        std::cerr << "Skipped " << list.malformed_lines << " malformed lines\n";
+    }
 
-    std::string line;
-    while (std::getline(input, line)) {
-        std::istringstream iss(line);
-        int a, b;
-        
-        if (iss >> a >> b) {
-            // Make the reverse
-            std::pair<int,int> e{a, b}, rev{b,a};
-            //Check if the reverse is in the set
-            if (seen.count(rev) || seen.count(e)) {
-                continue;
-            }
+    size_t num_edges = list.edges.size();
+    size_t num_nodes = list.active_node_num;
 
-            edges.emplace_back(a, b);
-            seen.insert(e);
-            num_edges++;
-            
-            nodes.insert(a);
-            nodes.insert(b);
-            
-            // if (a == b) {
-            //     std::cout << "Self Edge" << std::endl;
-            // }
+    ApproximateArboricity A;
+    A.Compute(list.node_num, num_edges, [&] (long k) {
+        return std::make_tuple(list.edges[k].first, list.edges[k].second, 1);
+    }, eps);
+    if (densest_eps >= 0) A.ComputeDensity(densest_eps, densest_iterations);
 
-        } else {
-            std::cerr << "Skipping malformed line: " << line << '\n';
+    if (A.degeneracy >= 0) std::cerr << "Degeneracy " << A.degeneracy << "\n";
+    std::cerr << "Peeling rounds " << A.round_num << "\n";
+    std::cerr << "Densest subgraph density in [" << A.density_lower << "," << A.density_upper << "]\n";
+
+    if (cover_file) {
+        // "i j forest" per edge
+        FILE* fp = fopen(cover_file, "w");
+        if (!fp) {
+            std::cerr << "Error opening " << cover_file << "\n";
+            return 1;
         }
+        for (size_t k = 0; k < num_edges; k++) {
+            fprintf(fp, "%d %d %d\n", list.edges[k].first, list.edges[k].second, A.forest[k]);
+        }
+        fclose(fp);
     }
 
-    num_nodes = nodes.size();
-
-    int largest_deg = find_largest_deg(edges, num_nodes);
-
-    // std::cout << "Arboricity estimate is " << num_edges / largest_deg << std::endl;
-    std::cout << num_edges / largest_deg << std::endl;
-}
-
-int find_largest_deg(const std::vector<std::pair<int, int>>& edges, int num_nodes) {
-    std::vector<int> degree(num_nodes, 0);
-    for (const auto& e : edges) {
-        int u = e.first;
-        int v = e.second;
-        degree[u] += 1;
-        degree[v] += 1;
+    // the arboricity if the bounds meet, the bracket [lower,upper] otherwise
+    if (A.lower == A.upper) {
+        std::cout << A.upper << std::endl;
+    } else {
+        std::cout << "[" << A.lower << "," << A.upper << "]" << std::endl;
     }
-    int max_degree = *std::max_element(degree.begin(), degree.end());
-    // std::cout << max_degree << std::endl;
-    return max_degree;
+    std::cout << num_nodes << std::endl;
+    std::cout << num_edges << std::endl;
 }
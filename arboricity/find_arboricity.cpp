@@ -1,78 +1,178 @@
 #include <iostream>
-#include <fstream>
+#include <string>
+#include <optional>
+#include <tuple>
+#include <vector>
 #include <stdio.h>
 #include <stdlib.h>
-#include <vector>
-#include <string>
-#include <sstream>
-#include <unordered_set>
 #include "arboricity.h"
-
-struct PairHash {
-    size_t operator()(const std::pair<int,int>& p) const noexcept {
-        // pack into 64 bits
-        return std::hash<long long>()(
-            (static_cast<long long>(p.first) << 32) ^ p.second
-        );
-    }
-};
+#include "densest_subgraph.h"
+#include "edge_list.h"
+#include "orientation_file.h"
 
 int main(int argc, char **argv) {
-    std::vector<std::pair<int, int>> edges;
-    std::unordered_set<std::pair<int,int>, PairHash> seen;
-    std::unordered_set<int> nodes;
-
-    std::string data_file  = argv[1];
-    std::ifstream input(data_file);
-
-    size_t num_edges = 0;
-    size_t num_nodes;
+    const char* data_file = NULL;
+    double time_budget = -1;
+    MaxflowBackend maxflow_backend = MAXFLOW_ORIENTATION;
+    UndirectedGraph::SpanningForestType forest_type = UndirectedGraph::FOREST_PARENT_POINTERS;
+    bool component_solving = true;
+    bool core_pruning = true;
+    bool greedy_forests = false;
+    bool refine = false;
+    int probe_num = 1;
+    bool print_stats = false;
+    const char* checkpoint_file = NULL;
+    double checkpoint_interval = 600;
+    bool resume = false;
+    const char* densest_file = NULL;
+    const char* orientation_file = NULL;
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (arg == "--time-budget" && a + 1 < argc) {
+            time_budget = atof(argv[++a]);
+        } else if (arg == "--maxflow" && a + 1 < argc) {
+            std::string b = argv[++a];
+            if (b == "bk") {
+                maxflow_backend = MAXFLOW_BK;
+            } else if (b == "push-relabel") {
+                maxflow_backend = MAXFLOW_PUSH_RELABEL;
+            } else if (b == "orientation") {
+                maxflow_backend = MAXFLOW_ORIENTATION;
+            } else {
+                std::cerr << "Unknown max-flow backend " << b << " (expected bk, push-relabel or orientation)\n";
+                return 1;
+            }
+        } else if (arg == "--probes" && a + 1 < argc) {
+            probe_num = atoi(argv[++a]);
+        } else if (arg == "--forest" && a + 1 < argc) {
+            std::string f = argv[++a];
+            if (f == "parents") {
+                forest_type = UndirectedGraph::FOREST_PARENT_POINTERS;
+            } else if (f == "link-cut") {
+                forest_type = UndirectedGraph::FOREST_LINK_CUT;
+            } else {
+                std::cerr << "Unknown forest representation " << f << " (expected parents or link-cut)\n";
+                return 1;
+            }
+        } else if (arg == "--no-components") {
+            component_solving = false;
+        } else if (arg == "--no-core-pruning") {
+            core_pruning = false;
+        } else if (arg == "--stats") {
+            print_stats = true;
+        } else if (arg == "--checkpoint" && a + 1 < argc) {
+            checkpoint_file = argv[++a];
+        } else if (arg == "--checkpoint-interval" && a + 1 < argc) {
+            checkpoint_interval = atof(argv[++a]);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--greedy-forests") {
+            greedy_forests = true;
+        } else if (arg == "--refine") {
+            refine = true;
+        } else if (arg == "--densest" && a + 1 < argc) {
+            densest_file = argv[++a];
+        } else if (arg == "--orientation" && a + 1 < argc) {
+            orientation_file = argv[++a];
+        } else if (arg[0] != '-' && !data_file) {
+            data_file = argv[a];
+        } else {
+            std::cerr << "Unknown option or missing value: " << arg << "\n";
+            data_file = NULL;
+            break;
+        }
+    }
+    if (!data_file || (resume && !checkpoint_file)) {
+        std::cerr << "Usage: " << argv[0] << " [--time-budget SECONDS] [--maxflow bk|push-relabel|orientation] [--probes P] [--forest parents|link-cut] [--no-components] [--no-core-pruning] [--greedy-forests] [--refine] [--densest FILE] [--orientation FILE] [--stats] [--checkpoint FILE [--checkpoint-interval SECONDS] [--resume]] <edge list file>\n";
+        return 1;
+    }
 
-    if (!input) {
+    EdgeList list;
+    if (!list.Load(data_file)) {
 		std::cerr << "Error opening an input file.\n";
         return 1;
 	}
+    if (list.malformed_lines > 0) {
+        std::cerr << "Skipped " << list.malformed_lines << " malformed lines\n";
+    }
 
-    std::string line;
-    while (std::getline(input, line)) {
-        std::istringstream iss(line);
-        int a, b;
-        
-        if (iss >> a >> b) {
-            // Make the reverse
-            std::pair<int,int> e{a, b}, rev{b,a};
-            //Check if the reverse is in the set
-            if (seen.count(rev) || seen.count(e)) {
-                continue;
-            }
-
-            edges.emplace_back(a, b);
-            seen.insert(e);
-            num_edges++;
+    size_t num_edges = list.edges.size();
+    size_t num_nodes = list.active_node_num;
 
-            nodes.insert(a);
-            nodes.insert(b);
-            
-            // if (a == b) {
-            //     std::cout << "Self Edge" << std::endl;
-            // }
+    UndirectedGraph* g = new UndirectedGraph(list.node_num, num_edges);
+    g->AddEdges(num_edges, list.edges.data(), 1);
 
-        } else {
-            std::cerr << "Skipping malformed line: " << line << '\n';
-        }
+    g->SetTimeBudget(time_budget);
+    g->SetMaxflowBackend(maxflow_backend);
+    g->SetParallelProbes(probe_num);
+    g->SetStats(print_stats);
+    g->SetSpanningForestType(forest_type);
+    g->SetComponentSolving(component_solving);
+    g->SetCorePruning(core_pruning);
+    g->SetGreedyForests(greedy_forests);
+    g->SetOrientationRefinement(refine);
+    g->SetDensestSubgraph(densest_file != NULL);
+    if (checkpoint_file) g->SetCheckpoint(checkpoint_file, checkpoint_interval, resume);
+    int forest_num = g->Solve();
+    if (forest_num >= 0) {
+        std::cout << forest_num << std::endl;
+    } else {
+        // out of time: report the bracket [lower,upper] on the arboricity
+        int lower, upper;
+        g->GetBounds(&lower, &upper);
+        std::cerr << "Time budget exceeded\n";
+        std::cout << "[" << lower << "," << upper << "]" << std::endl;
     }
+    std::cout << num_nodes << std::endl;
+    std::cout << num_edges << std::endl;
 
-    num_nodes = nodes.size();
+    if (densest_file) {
+        // the witness, checked against the input edges
+        std::vector<int> S(list.node_num);
+        int num = g->GetDensestSubgraph(S.data());
+        long weight = InducedWeight(list.node_num, num_edges, [&] (long k) {
+            return std::make_tuple(list.edges[k].first, list.edges[k].second, 1);
+        }, S.data(), num);
+        if (weight != g->GetDensestWeight()) {
+            std::cerr << "Error: the densest subgraph has " << weight << " edges instead of " << g->GetDensestWeight() << "\n";
+            return 1;
+        }
+        double density = (num > 0) ? (double)weight / num : 0;
+        std::cerr << "Densest subgraph: " << num << " nodes, " << weight << " edges, density " << density << "\n";
 
-    UndirectedGraph* g = new UndirectedGraph(num_nodes, num_edges);
-    for (const auto& e : edges) {
-        int u = e.first;
-        int v = e.second;
-        g->AddEdge(u, v, 1);
+        // a comment line, then one node id per line
+        FILE* fp = fopen(densest_file, "w");
+        if (!fp) {
+            std::cerr << "Error opening " << densest_file << "\n";
+            return 1;
+        }
+        fprintf(fp, "# %d nodes, %ld edges, density %.6f\n", num, weight, density);
+        for (int p = 0; p < num; p++) {
+            fprintf(fp, "%d\n", S[p]);
+        }
+        fclose(fp);
     }
-
-    std::cout << g->Solve() << std::endl;
-    std::cout << num_nodes << std::endl;
-    std::cout << num_edges << std::endl;
+    if (orientation_file && forest_num < 0) {
+        std::cerr << "No orientation written, the forests are not complete\n";
+    } else if (orientation_file) {
+        // every edge from child to parent in its forest, so that every node has out-degree <= forest_num
+        parlay::sequence<std::pair<int,int>> arcs;
+        std::vector<int> parents(list.node_num);
+        for (int f = 0; f < forest_num; f++) {
+            g->GetForestParents(f, parents.data());
+            arcs.append(parlay::map_maybe(parlay::iota<int>(list.node_num), [&] (int i) -> std::optional<std::pair<int,int>> {
+                if (parents[i] < 0) return std::nullopt;
+                return std::make_pair(i, parents[i]);
+            }));
+        }
+        if (arcs.size() != num_edges) {
+            std::cerr << "Error: the forests have " << arcs.size() << " edges instead of " << num_edges << "\n";
+            return 1;
+        }
+        if (!WriteOrientation(orientation_file, list.node_num, arcs)) {
+            std::cerr << "Error writing " << orientation_file << "\n";
+            return 1;
+        }
+    }
+    if (print_stats) g->GetStats()->PrintJSON(stderr); // solver statistics as JSON
 }
-
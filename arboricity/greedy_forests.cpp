@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include <parlay/utilities.h>
+#include "arboricity.h"
+#include "concurrent_union_find.h"
+
+// Greedy peeling of maximal spanning forests (called before Compact(), when edges[2*k] is the k'th user edge).
+// Every forest is grown in deterministic rounds of hooking: each edge between two trees reserves the larger of its two
+// roots with parlay::write_min() on its id, and the winners link that root below the smaller one. A root hooks at most
+// once per round and always to a smaller root, so the winners of a round are acyclic, and the forest is maximal once no
+// edge joins two trees. A complete cover bounds both k0 and forest_num by greedy_forest_num; peeling stops once
+// arboricity_upper forests are reached, since the bound would not improve (the first forest is still used by SeedForests()).
+void UndirectedGraph::ComputeGreedyForests()
+{
+	auto left = parlay::tabulate(user_edge_num, [&] (EdgeId k) { return edges[2*k].weight; }); // copies not in a forest yet
+	auto remaining = parlay::filter(parlay::iota<EdgeId>(user_edge_num), [&] (EdgeId k) { return left[k] > 0; });
+	ConcurrentUnionFind U(node_num);
+	auto hooks = parlay::tabulate<std::atomic<EdgeId>>(node_num, [] (long) { return INT_MAX; });
+	std::vector<parlay::sequence<EdgeId>> F;
+
+	while (remaining.size() > 0 && (int)F.size() < arboricity_upper)
+	{
+		parlay::sequence<EdgeId> forest, candidates = remaining;
+		U.Reset();
+		while (candidates.size() > 0)
+		{
+			// reserve
+			auto roots = parlay::map(candidates, [&] (EdgeId k) {
+				NodeId r0 = U.Find(edges[2*k].i[0]), r1 = U.Find(edges[2*k].i[1]);
+				return std::make_pair(std::max(r0, r1), std::min(r0, r1));
+			});
+			auto crossing = parlay::pack_index<long>(parlay::delayed_map(roots, [] (const std::pair<NodeId,NodeId>& r) { return r.first != r.second; }));
+			parlay::for_each(crossing, [&] (long p) { parlay::write_min(&hooks[roots[p].first], candidates[p], std::less<EdgeId>()); });
+
+			// commit
+			auto won = parlay::delayed_map(crossing, [&] (long p) { return hooks[roots[p].first].load() == candidates[p]; });
+			auto winners = parlay::pack(crossing, won);
+			parlay::for_each(winners, [&] (long p) {
+				U.Link(roots[p].first, roots[p].second);
+				hooks[roots[p].first] = INT_MAX;
+			});
+			forest.append(parlay::map(winners, [&] (long p) { return candidates[p]; }));
+			candidates = parlay::map(parlay::pack(crossing, parlay::delayed_map(won, [] (bool w) { return !w; })), [&] (long p) { return candidates[p]; });
+		}
+
+		parlay::for_each(forest, [&] (EdgeId k) { left[k] --; });
+		remaining = parlay::filter(remaining, [&] (EdgeId k) { return left[k] > 0; });
+		F.push_back(std::move(forest));
+	}
+
+	greedy_forest_num = (int)F.size();
+	greedy_first = new long[greedy_forest_num+1];
+	greedy_first[0] = 0;
+	for (int f=0; f<greedy_forest_num; f++) greedy_first[f+1] = greedy_first[f] + F[f].size();
+	greedy_edges = new EdgeId[greedy_first[greedy_forest_num]];
+	parlay::parallel_for(0, greedy_forest_num, [&] (int f) {
+		parlay::copy(F[f], parlay::make_slice(greedy_edges + greedy_first[f], greedy_edges + greedy_first[f+1]));
+	}, 1);
+
+	if (remaining.size() == 0)
+	{
+		arboricity_upper = std::min(arboricity_upper, greedy_forest_num);
+		k0_upper = std::min(k0_upper, greedy_forest_num);
+	}
+}
+
+// Called by ComputeForests() after Compact(). A complete solution has indegree k at every node (counting the source
+// edges), which the k forests give if every node has one parent in each of them. So every edge of a greedy forest becomes
+// its copy that still has weight, unless the head of that copy already has a parent in the forest: then the edge is
+// dropped (a subset of a forest stays acyclic). Nodes without a parent are attached to the source where its edges allow it.
+// Only the first greedy forest is used: with more of them ComputeForests() got up to 20 times slower on the test graphs,
+// since the seeded forests leave many nodes short of incoming edges, which takes long augmenting paths to repair.
+void UndirectedGraph::SeedForests(int k)
+{
+	int s = std::min(std::min(k, greedy_forest_num), 1), f;
+	if (s <= 0) return;
+
+	// the copies of user edge k are compact edges first_copy[k], first_copy[k]+1, ... (in increasing order)
+	auto first_copy = parlay::sequence<EdgeId>(user_edge_num, -1);
+	parlay::parallel_for(0, edge_num, [&] (EdgeId e) {
+		if (e == 0 || compacting_mapping[e-1] != compacting_mapping[e]) first_copy[compacting_mapping[e]] = e;
+	});
+
+	std::vector<EdgeId> list;
+	std::vector<bool> has_parent(node_num);
+	long p;
+	NodeId i;
+	for (f=0; f<s; f++)
+	{
+		list.clear();
+		std::fill(has_parent.begin(), has_parent.end(), false);
+		for (p=greedy_first[f]; p<greedy_first[f+1]; p++)
+		{
+			EdgeId e = first_copy[greedy_edges[p]];
+			if (edges[e].weight == 0 || has_parent[edges[e].i[1]]) e ++;
+			if (e < edge_num && compacting_mapping[e] == greedy_edges[p] && edges[e].weight > 0 && !has_parent[edges[e].i[1]])
+			{
+				edges[e].weight --;
+				list.push_back(e);
+				has_parent[edges[e].i[1]] = true;
+			}
+		}
+		for (i=0; i<node_num; i++)
+		{
+			if (!has_parent[i] && edges[i+edge_num].weight > 0)
+			{
+				edges[i+edge_num].weight --;
+				list.push_back(i+edge_num);
+				has_parent[i] = true;
+			}
+			if (has_parent[i]) nodes[i].incoming ++;
+		}
+
+		EdgeId* parents = parent_arena.Allocate();
+		if (forest_type == FOREST_LINK_CUT) forests[f] = new SpanningForest(node_num + 1, nodes, edges, parents, edge_num + node_num);
+		else                                forests[f] = new SpanningForest(node_num + 1, nodes, edges, parents);
+		forests[f]->SetEdges(list.data(), (int)list.size());
+	}
+	forest_num = s;
+	if (stats) stats->forests_added += s;
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+
+// Incremental mode. The forests are kept over the copies of the user edges only (the source edges of ComputeForests()
+// are dropped): user edge k has copies edges[2k] and edges[2k+1], and every copy inserted so far is in a forest (weight 0).
+// An inserted edge gets its whole weight on edges[2k] and goes in by Search()/Augment() as in ComputeForests(). By the
+// matroid partition theorem a search fails only if the forests plus this copy cannot be covered by forest_num forests,
+// so a new forest is added only then, and forest_num stays equal to the arboricity.
+void UndirectedGraph::InitIncremental()
+{
+	int n = node_num, k = forest_num, f;
+	NodeId i;
+
+	// the current cover and the endpoints of every user edge (Compact() dropped the edges of weight 0: they get (-1,-1))
+	EdgeId* F = new EdgeId[(long)k*n];
+	for (f=0; f<k; f++) GetForestEdges(f, F + (long)f*n);
+	auto ends = parlay::sequence<std::pair<NodeId,NodeId>>(user_edge_num, std::make_pair(-1, -1));
+	if (compacting_mapping)
+	{
+		parlay::parallel_for(0, edge_num, [&] (EdgeId e) {
+			if (e == 0 || compacting_mapping[e-1] != compacting_mapping[e]) ends[compacting_mapping[e]] = std::make_pair(edges[e].i[0], edges[e].i[1]);
+		});
+	}
+	else parlay::parallel_for(0, user_edge_num, [&] (EdgeId e) { ends[e] = std::make_pair(edges[2*e].i[0], edges[2*e].i[1]); });
+
+	if (forests)
+	{
+		for (f=0; f<k; f++) delete forests[f];
+		delete [] forests;
+	}
+	DeleteWorkspaces();
+	if (compacting_mapping) { delete [] compacting_mapping; compacting_mapping = NULL; }
+	if (user_parents) { delete [] user_parents; user_parents = NULL; }
+
+	edge_num = 2*user_edge_num;
+	parlay::parallel_for(0, user_edge_num, [&] (EdgeId e) {
+		edges[2*e  ].i[0] = ends[e].first;  edges[2*e  ].i[1] = ends[e].second; edges[2*e  ].weight = 0;
+		edges[2*e+1].i[0] = ends[e].second; edges[2*e+1].i[1] = ends[e].first;  edges[2*e+1].weight = 0;
+	});
+	for (i=0; i<=n; i++) nodes[i].first_incoming = -1;
+	for (EdgeId e=0; e<edge_num; e++)
+	{
+		if (edges[e].i[1] < 0) continue;
+		edges[e].next_incoming = nodes[edges[e].i[1]].first_incoming;
+		nodes[edges[e].i[1]].first_incoming = e;
+	}
+	parlay::parallel_for(0, n, [&] (NodeId i) {
+		int c = 0;
+		for (int f=0; f<k; f++) if (F[(long)f*n + i] >= 0) c ++;
+		nodes[i].incoming = c;
+	});
+	nodes[n].incoming = 0;
+
+	// forest edges as the copies towards the child
+	forests = new SpanningForest*[k];
+	parent_arena.Init(n + 1);
+	for (f=0; f<k; f++)
+	{
+		EdgeId* parents = parent_arena.Allocate();
+		if (forest_type == FOREST_LINK_CUT) forests[f] = new SpanningForest(n + 1, nodes, edges, parents, edge_num_max);
+		else                                forests[f] = new SpanningForest(n + 1, nodes, edges, parents);
+	}
+	parlay::parallel_for(0, k, [&] (int f) {
+		EdgeId* P = F + (long)f*n;
+		auto list = parlay::map(parlay::filter(parlay::iota<NodeId>(n), [&] (NodeId i) { return P[i] >= 0; }), [&] (NodeId i) {
+			return (edges[2*P[i]].i[1] == i) ? 2*P[i] : 2*P[i]+1;
+		});
+		forests[f]->SetEdges(list.data(), (int)list.size());
+	}, 1);
+	delete [] F;
+
+	workspace_num = 1;
+	workspaces = new SearchWorkspace*[1];
+	workspaces[0] = new SearchWorkspace(edge_num_max, node_num);
+	incremental = true;
+}
+
+int UndirectedGraph::InsertEdges(int num, const std::pair<NodeId,NodeId>* ij, int weight)
+{
+	if ((!compacting_mapping && !user_parents && !incremental) || arboricity_lower != arboricity_upper)
+	{
+		printf("Error: InsertEdges() can only be called after a complete Solve()\n");
+		exit(1);
+	}
+	if (!incremental) InitIncremental();
+
+	double start = GetTime();
+	EdgeId first = AddEdges(num, ij, weight), k;
+	int forest_num_old = forest_num;
+	for (k=first; k<first+num; k++)
+	{
+		Edge* e = &edges[2*k];
+		edges[2*k+1].weight = 0;
+		e->next_incoming = nodes[e->i[1]].first_incoming;
+		nodes[e->i[1]].first_incoming = 2*k;
+		edges[2*k+1].next_incoming = nodes[e->i[0]].first_incoming;
+		nodes[e->i[0]].first_incoming = 2*k+1;
+	}
+
+	for (k=first; k<first+num; k++)
+	{
+		Edge* e = &edges[2*k];
+		while (e->weight > 0)
+		{
+			// the search may insert another pending copy towards the same node, which is as good
+			Edge* a = Search(e->i[1], workspaces[0]);
+			if (a)
+			{
+				Augment(a, workspaces[0]);
+				continue;
+			}
+
+			SpanningForest** forests_old = forests;
+			forests = new SpanningForest*[forest_num+1];
+			memcpy(forests, forests_old, forest_num*sizeof(SpanningForest*));
+			delete [] forests_old;
+			EdgeId* parents = parent_arena.Allocate();
+			if (forest_type == FOREST_LINK_CUT) forests[forest_num ++] = new SpanningForest(node_num + 1, nodes, edges, parents, edge_num_max);
+			else                                forests[forest_num ++] = new SpanningForest(node_num + 1, nodes, edges, parents);
+			if (stats) stats->forests_added ++;
+		}
+	}
+
+	CollectSearchStats();
+	if (stats)
+	{
+		if (forest_num > forest_num_old) stats->forest_growths ++;
+		stats->time_insert += GetTime() - start;
+	}
+
+	arboricity_lower = arboricity_upper = forest_num;
+	return forest_num;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+#include "link_cut_tree.h"
+
+LinkCutTree::LinkCutTree(int _node_num)
+	: node_num(_node_num)
+{
+	int i;
+	nodes = new Node[node_num];
+	stack = new int[node_num];
+	for (i=0; i<node_num; i++)
+	{
+		nodes[i].child[0] = nodes[i].child[1] = nodes[i].parent = -1;
+		nodes[i].flip = false;
+	}
+}
+
+LinkCutTree::~LinkCutTree()
+{
+	delete [] nodes;
+	delete [] stack;
+}
+
+void LinkCutTree::Push(int x)
+{
+	if (!nodes[x].flip) return;
+	std::swap(nodes[x].child[0], nodes[x].child[1]);
+	if (nodes[x].child[0] >= 0) nodes[nodes[x].child[0]].flip ^= true;
+	if (nodes[x].child[1] >= 0) nodes[nodes[x].child[1]].flip ^= true;
+	nodes[x].flip = false;
+}
+
+void LinkCutTree::Rotate(int x)
+{
+	int p = nodes[x].parent, g = nodes[p].parent;
+	int d = (nodes[p].child[1] == x) ? 1 : 0;
+	int b = nodes[x].child[d^1];
+
+	if (!IsSplayRoot(p)) nodes[g].child[(nodes[g].child[1] == p) ? 1 : 0] = x;
+	nodes[x].parent = g;
+	nodes[p].child[d] = b;
+	if (b >= 0) nodes[b].parent = p;
+	nodes[x].child[d^1] = p;
+	nodes[p].parent = x;
+}
+
+void LinkCutTree::Splay(int x)
+{
+	// push the pending reversals down from the root of the splay tree
+	int sp = 0, y = x;
+	stack[sp ++] = y;
+	while (!IsSplayRoot(y)) { y = nodes[y].parent; stack[sp ++] = y; }
+	while (sp > 0) Push(stack[-- sp]);
+
+	while (!IsSplayRoot(x))
+	{
+		int p = nodes[x].parent;
+		if (!IsSplayRoot(p))
+		{
+			int g = nodes[p].parent;
+			bool zigzig = ((nodes[g].child[1] == p) == (nodes[p].child[1] == x));
+			Rotate(zigzig ? p : x);
+		}
+		Rotate(x);
+	}
+}
+
+int LinkCutTree::Access(int x)
+{
+	int last = -1, y;
+	for (y=x; y>=0; y=nodes[y].parent)
+	{
+		Splay(y);
+		nodes[y].child[1] = last;
+		last = y;
+	}
+	Splay(x);
+	return last;
+}
+
+void LinkCutTree::Evert(int x)
+{
+	Access(x);
+	nodes[x].flip ^= true;
+	Push(x);
+}
+
+int LinkCutTree::FindRoot(int x)
+{
+	Access(x);
+	while ( 1 )
+	{
+		Push(x);
+		if (nodes[x].child[0] < 0) break;
+		x = nodes[x].child[0];
+	}
+	Splay(x);
+	return x;
+}
+
+void LinkCutTree::Link(int u, int v)
+{
+	Evert(u);
+	nodes[u].parent = v;
+}
+
+void LinkCutTree::Cut(int u, int v)
+{
+	Evert(u);
+	Access(v);
+	if (nodes[v].child[0] != u || nodes[u].child[1] >= 0) { printf("Error in LinkCutTree::Cut(): not an edge\n"); exit(1); }
+	nodes[v].child[0] = -1;
+	nodes[u].parent = -1;
+}
+
+bool LinkCutTree::Connected(int u, int v)
+{
+	return u == v || FindRoot(u) == FindRoot(v);
+}
+
+int LinkCutTree::LCA(int u, int v)
+{
+	if (!Connected(u, v)) return -1;
+	Access(u);
+	return Access(v);
+}
@@ -0,0 +1,65 @@
+#ifndef __LINK_CUT_TREE_H__
+#define __LINK_CUT_TREE_H__
+
+// Link-cut trees (Sleator and Tarjan) on nodes [0,node_num-1]: splay trees over preferred paths,
+// with lazy path reversal for re-rooting. All operations take O(log node_num) amortized time,
+// ForEachOnPath() additionally takes time linear in the length of the path.
+class LinkCutTree
+{
+public:
+	LinkCutTree(int node_num); // every node starts as a tree of its own
+	~LinkCutTree();
+
+	void Link(int u, int v); // u and v must be in different trees. Makes u the root of its tree, then a child of v
+	void Cut(int u, int v); // (u,v) must be an edge
+	bool Connected(int u, int v);
+	int LCA(int u, int v); // lowest common ancestor w.r.t. the current root of the tree (or -1, if in different trees)
+
+	// u and v must be connected. Calls f(w) for every node w on the path from u to v (inclusive), in this order,
+	// and makes u the root of the tree. f must not call other LinkCutTree functions.
+	template <class F> void ForEachOnPath(int u, int v, F f);
+
+private:
+	struct Node
+	{
+		int child[2];
+		int parent; // parent in the splay tree, or path-parent if the node is the root of its splay tree
+		bool flip; // the subtree must be reversed
+	};
+
+	int node_num;
+	Node* nodes;
+	int* stack; // of size node_num
+
+	bool IsSplayRoot(int x) { int p = nodes[x].parent; return p < 0 || (nodes[p].child[0] != x && nodes[p].child[1] != x); }
+	void Push(int x);
+	void Rotate(int x);
+	void Splay(int x);
+	int Access(int x); // makes the path from the root to x preferred, and x the root of its splay tree.
+	                   // Returns the last node where the path joined the previous preferred path
+	void Evert(int x); // makes x the root of its tree
+	int FindRoot(int x);
+};
+
+template <class F> void LinkCutTree::ForEachOnPath(int u, int v, F f)
+{
+	Evert(u);
+	Access(v);
+
+	// the splay tree of v now holds exactly the path from u to v: traverse it in order
+	int sp = 0, x = v;
+	while (x >= 0 || sp > 0)
+	{
+		while (x >= 0)
+		{
+			Push(x);
+			stack[sp ++] = x;
+			x = nodes[x].child[0];
+		}
+		x = stack[-- sp];
+		f(x);
+		x = nodes[x].child[1];
+	}
+}
+
+#endif
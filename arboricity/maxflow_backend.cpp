@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <tuple>
+#include <parlay/primitives.h>
+#include "maxflow_backend.h"
+#include "push_relabel.h"
+#include "orientation_flow.h"
+#include "maxflow-v3.04.src/graph.h"
+
+class BKMaxflow : public ArboricityMaxflow
+{
+public:
+	typedef Graph<int,int,int> G;
+
+	BKMaxflow(int _node_num, int _edge_num, const std::pair<int,int>* ends, const int* weight)
+		: node_num(_node_num), edge_num(_edge_num), k_current(0), solved(false)
+	{
+		// nodes [0,edge_num-1] are edge nodes, [edge_num,edge_num+node_num-1] vertex nodes
+		int e;
+		long weight_sum = 0;
+		for (e=0; e<edge_num; e++) weight_sum += weight[e];
+		int infinity = (weight_sum < 0x7fffffff) ? (int)weight_sum : 0x7fffffff;
+
+		g = new G(node_num + edge_num, 2*edge_num);
+		g->add_node(node_num + edge_num);
+		for (e=0; e<edge_num; e++)
+		{
+			g->add_tweights(e, weight[e], 0);
+			g->add_edge(e, ends[e].first  + edge_num, infinity, 0);
+			g->add_edge(e, ends[e].second + edge_num, infinity, 0);
+		}
+	}
+	~BKMaxflow() { delete g; }
+
+	void SetSinkCapacity(int k)
+	{
+		// For a warm start only nodes whose residual terminal capacity changes sign (or becomes/stops being zero)
+		// must be marked, the others stay valid roots of their search trees (see mark_node() in graph.h).
+		int i;
+		for (i=0; i<node_num; i++)
+		{
+			int before = g->get_trcap(i + edge_num);
+			g->add_tweights(i + edge_num, 0, k - k_current); // may be negative, which BK supports
+			int after = g->get_trcap(i + edge_num);
+			if (solved && ((before > 0) != (after > 0) || (before < 0) != (after < 0))) g->mark_node(i + edge_num);
+		}
+		k_current = k;
+	}
+	long Maxflow(bool warm_start)
+	{
+		long flow = g->maxflow(warm_start && solved); // reuse_trees cannot be used in the first call
+		solved = true;
+		return flow;
+	}
+	int GetFlow(int e, int d)
+	{
+		// arcs of edge e are 4*e (e->ends[e].first), 4*e+2 (e->ends[e].second); the sister arc's residual capacity is the flow
+		G::arc_id a = g->get_first_arc() + 4*e + 2*d + 1;
+		return g->get_rcap(a);
+	}
+	void GetSourceSide(char* side)
+	{
+		// nodes in neither search tree are not reachable from the source
+		for (int i=0; i<node_num; i++) side[i] = (g->what_segment(i + edge_num, G::SINK) == G::SOURCE) ? 1 : 0;
+	}
+
+private:
+	int node_num, edge_num, k_current;
+	bool solved;
+	G* g;
+};
+
+class PushRelabelMaxflow : public ArboricityMaxflow
+{
+public:
+	PushRelabelMaxflow(int _node_num, int _edge_num, const std::pair<int,int>* ends, const int* weight)
+		: node_num(_node_num), edge_num(_edge_num)
+	{
+		// nodes: edge nodes [0,edge_num-1], vertex nodes [edge_num,edge_num+node_num-1], sink edge_num+node_num.
+		// The source is implicit: its arcs are always saturated, so edge node e starts with excess weight[e].
+		// arcs: 2*e+d from edge node e to its d'th endpoint, 2*edge_num+i from vertex node i to the sink
+		long weight_sum = parlay::reduce(parlay::make_slice(weight, weight + edge_num), parlay::plus<long>());
+		int infinity = (weight_sum < 0x7fffffff) ? (int)weight_sum : 0x7fffffff;
+		int sink = edge_num + node_num;
+
+		P.Init(edge_num + node_num + 1, 2*(long)edge_num + node_num, sink, [&] (long a) {
+			if (a < 2*(long)edge_num)
+			{
+				int e = (int)(a/2);
+				return std::make_tuple(e, edge_num + ((a & 1) ? ends[e].second : ends[e].first), infinity);
+			}
+			return std::make_tuple(edge_num + (int)(a - 2*(long)edge_num), sink, 0);
+		});
+		parlay::parallel_for(0, edge_num, [&] (int e) { P.AddExcess(e, weight[e]); });
+	}
+
+	void SetSinkCapacity(int k)
+	{
+		parlay::parallel_for(0, node_num, [&] (int i) { P.SetCapacity(2*(long)edge_num + i, k); });
+	}
+	long Maxflow(bool /*warm_start*/) { return P.Maxflow(stop); } // always continues from the current preflow
+	int GetFlow(int e, int d) { return P.GetFlow(2*(long)e + d); }
+	void GetSourceSide(char* side)
+	{
+		auto reached = parlay::sequence<char>(edge_num + node_num + 1);
+		P.GetSourceSide(reached.data());
+		parlay::parallel_for(0, node_num, [&] (int i) { side[i] = reached[edge_num + i]; });
+	}
+
+private:
+	int node_num, edge_num;
+	PushRelabel P;
+};
+
+class OrientationMaxflow : public ArboricityMaxflow
+{
+public:
+	OrientationMaxflow(int node_num, int edge_num, const std::pair<int,int>* ends, const int* weight)
+	{
+		F.Init(node_num, edge_num, ends, weight);
+	}
+
+	void SetSinkCapacity(int k) { F.SetK(k); }
+	long Maxflow(bool /*warm_start*/) { return F.Maxflow(stop); } // always continues from the current flow
+	int GetFlow(int e, int d) { return F.GetShare(e, d); }
+	void GetSourceSide(char* side) { F.GetSourceSide(side); }
+
+private:
+	OrientationFlow F;
+};
+
+ArboricityMaxflow* NewArboricityMaxflow(MaxflowBackend type, int node_num, int edge_num, const std::pair<int,int>* ends, const int* weight)
+{
+	switch (type)
+	{
+		case MAXFLOW_BK:           return new BKMaxflow(node_num, edge_num, ends, weight);
+		case MAXFLOW_PUSH_RELABEL: return new PushRelabelMaxflow(node_num, edge_num, ends, weight);
+		case MAXFLOW_ORIENTATION:  return new OrientationMaxflow(node_num, edge_num, ends, weight);
+	}
+	printf("Unknown max-flow backend\n");
+	exit(1);
+}
@@ -0,0 +1,45 @@
+#ifndef __MAXFLOW_BACKEND_H__
+#define __MAXFLOW_BACKEND_H__
+
+#include <atomic>
+#include <utility>
+
+// Max-flow solvers for the network of UndirectedGraph::Solve0():
+//   source -> edge node e (capacity weight[e]), edge node e -> each of its two endpoints (infinite capacity),
+//   vertex node v -> sink (capacity k, the same for every v).
+// The network only changes through SetSinkCapacity(), and backends keep their flow between calls to Maxflow().
+
+enum MaxflowBackend
+{
+	MAXFLOW_BK,            // sequential Boykov-Kolmogorov (maxflow-v3.04)
+	MAXFLOW_PUSH_RELABEL,  // parallel synchronous push-relabel
+	MAXFLOW_ORIENTATION    // Dinic's algorithm on the vertex graph, with the network implicit in its CSR (see orientation_flow.h)
+};
+
+class ArboricityMaxflow
+{
+public:
+	virtual ~ArboricityMaxflow() {}
+
+	virtual void SetSinkCapacity(int k) = 0;
+	// Returns the value of a maximum flow for the current capacities. With warm_start the backend may also continue from
+	// the search state of the previous call (BK: the search trees), which is cheaper but can route the new flow differently.
+	virtual long Maxflow(bool warm_start) = 0;
+	virtual int GetFlow(int e, int d) = 0; // flow from edge node e to its endpoint ends[e].first (d=0) or ends[e].second (d=1)
+	// After Maxflow() (unless it was stopped): side[i] = 1 for the vertex nodes i\in[0,node_num-1] that are reachable from the
+	// source in the residual network, 0 for the others. With the edge nodes between them this is the source side of a minimum
+	// cut, so if the flow is below the sum of the weights, these vertices S are not empty and the edges within S weigh more than k*|S|.
+	virtual void GetSourceSide(char* side) = 0;
+
+	// Once *stop becomes true, Maxflow() returns -1 at its next check (between two phases or rounds), keeping the flow
+	// found so far. Used by the parallel probes of Solve0(). BK does not check it.
+	void SetStopFlag(const std::atomic<bool>* _stop) { stop = _stop; }
+
+protected:
+	const std::atomic<bool>* stop = NULL;
+};
+
+// ends[e] and weight[e] for e\in[0,edge_num-1] describe the edges; both arrays are only read during construction.
+ArboricityMaxflow* NewArboricityMaxflow(MaxflowBackend type, int node_num, int edge_num, const std::pair<int,int>* ends, const int* weight);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef __ORIENTATION_FILE_H__
+#define __ORIENTATION_FILE_H__
+
+#include <stdio.h>
+#include <string.h>
+#include <tuple>
+#include <utility>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Binary file with an orientation of a graph, written by find_arboricity --orientation and read by the triangle counter
+// (main.cpp). Orienting every edge of a forest decomposition from child to parent gives every node out-degree at most
+// forest_num, the bound that makes triangle counting over out-neighbourhoods take O(arboricity) work per edge.
+//
+// Layout (native byte order): "ARBORNT1", long node_num, long arc_num, long offsets[node_num+1], int heads[arc_num].
+// The arcs leaving node i go to heads[offsets[i]..offsets[i+1]-1], in increasing order.
+static const char orientation_magic[8] = { 'A', 'R', 'B', 'O', 'R', 'N', 'T', '1' };
+
+// arcs[k] = (tail, head); they are sorted in parallel. Returns false if the file cannot be written
+inline bool WriteOrientation(const char* filename, long node_num, const parlay::sequence<std::pair<int,int>>& arcs)
+{
+	auto keys = parlay::integer_sort(parlay::map(arcs, [] (const std::pair<int,int>& a) {
+		return ((unsigned long long)(unsigned)a.first << 32) | (unsigned)a.second;
+	}));
+	auto heads = parlay::map(keys, [] (unsigned long long x) { return (int)(x & 0xffffffffULL); });
+	parlay::sequence<long> offsets(node_num+1, 0L);
+	if (arcs.size() > 0) // parlay::histogram_by_index() divides by zero on an empty input
+	{
+		long total;
+		std::tie(offsets, total) = parlay::scan(parlay::histogram_by_index(parlay::delayed_map(arcs, [] (const std::pair<int,int>& a) {
+			return (long)a.first;
+		}), node_num));
+		offsets.push_back(total);
+	}
+	long arc_num = (long)arcs.size();
+
+	FILE* fp = fopen(filename, "wb");
+	if (!fp) return false;
+	bool ok = fwrite(orientation_magic, 1, 8, fp) == 8
+	       && fwrite(&node_num, sizeof(long), 1, fp) == 1
+	       && fwrite(&arc_num, sizeof(long), 1, fp) == 1
+	       && fwrite(offsets.data(), sizeof(long), offsets.size(), fp) == offsets.size()
+	       && (arc_num == 0 || fwrite(heads.data(), sizeof(int), arc_num, fp) == (size_t)arc_num);
+	if (fclose(fp) != 0) ok = false;
+	return ok;
+}
+
+// Returns false if the file cannot be read or is not a valid orientation file
+inline bool ReadOrientation(const char* filename, parlay::sequence<long>& offsets, parlay::sequence<int>& heads)
+{
+	FILE* fp = fopen(filename, "rb");
+	if (!fp) return false;
+	char magic[8];
+	long node_num, arc_num;
+	bool ok = fread(magic, 1, 8, fp) == 8 && memcmp(magic, orientation_magic, 8) == 0
+	       && fread(&node_num, sizeof(long), 1, fp) == 1 && fread(&arc_num, sizeof(long), 1, fp) == 1
+	       && node_num >= 0 && arc_num >= 0;
+	if (ok)
+	{
+		offsets = parlay::sequence<long>(node_num + 1);
+		heads = parlay::sequence<int>(arc_num);
+		ok = fread(offsets.data(), sizeof(long), node_num + 1, fp) == (size_t)(node_num + 1)
+		  && (arc_num == 0 || fread(heads.data(), sizeof(int), arc_num, fp) == (size_t)arc_num);
+	}
+	fclose(fp);
+	if (ok) ok = offsets[0] == 0 && offsets[node_num] == arc_num
+	          && parlay::all_of(parlay::iota<long>(node_num), [&] (long i) { return offsets[i] <= offsets[i+1]; })
+	          && parlay::all_of(heads, [&] (int j) { return j >= 0 && j < node_num; });
+	return ok;
+}
+
+#endif
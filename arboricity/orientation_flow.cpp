@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <tuple>
+#include "orientation_flow.h"
+
+void OrientationFlow::Init(int node_num, int edge_num, const std::pair<int,int>* _ends, const int* _weight)
+{
+	n = node_num;
+	m = edge_num;
+	k = 0;
+	ends = parlay::tabulate(m, [&] (int e) { return _ends[e]; });
+	weight = parlay::tabulate(m, [&] (int e) { return _weight[e]; });
+	weight_sum = parlay::reduce(parlay::delayed_map(weight, [] (int w) { return (long)w; }));
+
+	// arcs grouped by tail
+	auto tails = parlay::delayed_tabulate(2*(long)m, [&] (long a) { return Tail((int)a); });
+	if (m == 0) first_arc = parlay::sequence<long>(n+1, 0L); // parlay::histogram_by_index() divides by zero on an empty input
+	else
+	{
+		auto counts = parlay::histogram_by_index(tails, (long)n);
+		long total;
+		std::tie(first_arc, total) = parlay::scan(counts);
+		first_arc.push_back(total);
+	}
+	arcs = parlay::integer_sort(parlay::tabulate(2*m, [] (int a) { return a; }), [&] (int a) { return (unsigned)Tail(a); });
+
+	// start with every edge on its endpoint of smaller degree
+	load = parlay::tabulate(m, [&] (int e) {
+		long d0 = first_arc[ends[e].first+1] - first_arc[ends[e].first];
+		long d1 = first_arc[ends[e].second+1] - first_arc[ends[e].second];
+		return (d0 <= d1) ? weight[e] : 0;
+	});
+	L = parlay::tabulate(n, [&] (int v) {
+		return parlay::reduce(parlay::delayed_tabulate(first_arc[v+1] - first_arc[v], [&] (long p) {
+			return (long)Capacity(arcs[first_arc[v] + p]);
+		}));
+	});
+
+	level = parlay::sequence<std::atomic<int>>(n);
+	current = parlay::sequence<long>(n, 0);
+}
+
+bool OrientationFlow::BuildLevels()
+{
+	parlay::parallel_for(0, n, [&] (int v) { level[v] = -1; });
+	auto frontier = parlay::filter(parlay::iota<int>(n), [&] (int v) { return L[v] > k; });
+	parlay::for_each(frontier, [&] (int v) { level[v] = 0; });
+
+	for (int d=1; frontier.size() > 0; d++)
+	{
+		frontier = parlay::flatten(parlay::map(frontier, [&] (int v) {
+			auto found = parlay::tabulate(first_arc[v+1] - first_arc[v], [&] (long p) {
+				int a = arcs[first_arc[v] + p];
+				int u = Head(a);
+				int expected = -1;
+				if (Capacity(a) > 0 && level[u].load() == -1 && level[u].compare_exchange_strong(expected, d)) return u;
+				return -1;
+			});
+			return parlay::filter(found, [] (int u) { return u >= 0; });
+		}));
+		if (parlay::any_of(frontier, [&] (int u) { return L[u] < k; }))
+		{
+			sink_level = d;
+			return true;
+		}
+	}
+	return false;
+}
+
+void OrientationFlow::Augment(int s)
+{
+	path.clear();
+	int v = s;
+	while (L[s] > k)
+	{
+		if (level[v] == sink_level)
+		{
+			if (L[v] < k)
+			{
+				long d = std::min(L[s] - k, k - L[v]);
+				for (int a : path) d = std::min(d, (long)Capacity(a));
+				for (int a : path) Move(a, (int)d);
+				path.clear();
+				v = s;
+				continue;
+			}
+		}
+		else
+		{
+			for ( ; current[v]<first_arc[v+1]; current[v]++)
+			{
+				int a = arcs[current[v]];
+				if (Capacity(a) > 0 && level[Head(a)] == level[v] + 1) break;
+			}
+			if (current[v] < first_arc[v+1])
+			{
+				int a = arcs[current[v]];
+				path.push_back(a);
+				v = Head(a);
+				continue;
+			}
+		}
+
+		// dead end: remove v from the level graph and retreat
+		level[v] = -1;
+		if (path.empty()) break;
+		v = Tail(path.back());
+		path.pop_back();
+		current[v] ++;
+	}
+}
+
+long OrientationFlow::Maxflow(const std::atomic<bool>* stop)
+{
+	while (BuildLevels())
+	{
+		auto sources = parlay::filter(parlay::iota<int>(n), [&] (int v) { return level[v] == 0; });
+		parlay::parallel_for(0, n, [&] (int v) { current[v] = first_arc[v]; });
+		for (int s : sources)
+		{
+			if (stop && stop->load()) return -1;
+			Augment(s);
+		}
+	}
+	long excess = parlay::reduce(parlay::delayed_map(L, [&] (long l) { return std::max(l - k, 0L); }));
+	return weight_sum - excess;
+}
@@ -0,0 +1,64 @@
+#ifndef __ORIENTATION_FLOW_H__
+#define __ORIENTATION_FLOW_H__
+
+#include <atomic>
+#include <utility>
+#include <vector>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Max-flow in the network of UndirectedGraph::Solve0() (see maxflow_backend.h) without materialising it.
+//
+// The source arcs are kept saturated: edge e always carries its whole weight, split into the share load[e] of its first
+// endpoint and weight[e]-load[e] of the second one (the flows on its two infinite arcs). Vertex v then receives
+// L(v) = sum of its shares, sends min(L(v),k) to the sink and holds the excess max(L(v)-k,0). Moving d units of e from v
+// to its other endpoint u is the residual path v -> e -> u, so the residual network reduces to the vertex graph with an
+// arc v->u for every edge, whose capacity is the share of v. The excess that cannot reach a vertex with L(u) < k this way
+// is exactly what a maximum flow leaves at the source.
+//
+// Maxflow() runs Dinic's algorithm from all vertices with excess to all vertices below k: level graphs by parallel BFS,
+// blocking flows by depth-first search with current-arc pointers. The flow is kept between calls, whatever k is.
+// Memory is one int per arc of the vertex graph (in CSR form) plus four ints per edge, and loads are 64-bit.
+class OrientationFlow
+{
+public:
+	// ends[e] and weight[e] for e\in[0,edge_num-1] describe the edges; the arrays are copied (in parallel)
+	void Init(int node_num, int edge_num, const std::pair<int,int>* ends, const int* weight);
+
+	void SetK(int _k) { k = _k; }
+	long Maxflow(const std::atomic<bool>* stop = NULL); // returns the total flow into the sink, or -1 if *stop was set (checked between augmentations)
+	int GetShare(int e, int d) { return (d == 0) ? load[e] : weight[e] - load[e]; } // flow from edge e to ends[e].first (d=0) or .second (d=1)
+	// After a complete Maxflow(): side[v] = 1 for the vertices reachable from the excess, i.e. the source side of a minimum cut
+	// (the last BuildLevels() of Maxflow() found no vertex below k, so its levels give them), 0 for the others
+	void GetSourceSide(char* side) { parlay::parallel_for(0, n, [&] (int v) { side[v] = (level[v].load() >= 0) ? 1 : 0; }); }
+
+private:
+	int n, m;
+	long k, weight_sum;
+
+	parlay::sequence<std::pair<int,int>> ends;
+	parlay::sequence<int> weight, load; // per edge
+	parlay::sequence<long> first_arc; // the arcs of v are arcs[first_arc[v]..first_arc[v+1]-1]
+	parlay::sequence<int> arcs; // arc 2*e+d leaves the d'th endpoint of e
+	parlay::sequence<long> L; // per vertex
+
+	parlay::sequence<std::atomic<int>> level;
+	int sink_level;
+	parlay::sequence<long> current; // current-arc pointers
+	std::vector<int> path;
+
+	int Tail(int a) { return (a & 1) ? ends[a/2].second : ends[a/2].first; }
+	int Head(int a) { return (a & 1) ? ends[a/2].first : ends[a/2].second; }
+	int Capacity(int a) { return GetShare(a/2, a & 1); }
+	void Move(int a, int d) // moves d units of the edge of a from its tail to its head
+	{
+		load[a/2] += (a & 1) ? d : -d;
+		L[Tail(a)] -= d;
+		L[Head(a)] += d;
+	}
+
+	bool BuildLevels(); // returns false if no vertex below k can be reached
+	void Augment(int s); // blocking flow from s
+};
+
+#endif
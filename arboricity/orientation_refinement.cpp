@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <tuple>
+#include "orientation_refinement.h"
+
+void OrientationRefinement::Init(int node_num, int edge_num, const std::pair<int,int>* _ends, const int* _weight, const int* share)
+{
+	n = node_num;
+	m = edge_num;
+	ends = parlay::tabulate(m, [&] (int e) { return _ends[e]; });
+	weight = parlay::tabulate(m, [&] (int e) { return _weight[e]; });
+	load = parlay::tabulate(m, [&] (int e) { return share[e]; });
+
+	// arcs grouped by tail
+	auto tails = parlay::delayed_tabulate(2*(long)m, [&] (long a) { return Tail((int)a); });
+	if (m == 0) first_arc = parlay::sequence<long>(n+1, 0L); // parlay::histogram_by_index() divides by zero on an empty input
+	else
+	{
+		auto counts = parlay::histogram_by_index(tails, (long)n);
+		long total;
+		std::tie(first_arc, total) = parlay::scan(counts);
+		first_arc.push_back(total);
+	}
+	arcs = parlay::integer_sort(parlay::tabulate(2*m, [] (int a) { return a; }), [&] (int a) { return (unsigned)Tail(a); });
+
+	L = parlay::tabulate(n, [&] (int v) {
+		return parlay::reduce(parlay::delayed_tabulate(first_arc[v+1] - first_arc[v], [&] (long p) {
+			return (long)Capacity(arcs[first_arc[v] + p]);
+		}));
+	});
+}
+
+long OrientationRefinement::Refine()
+{
+	auto proposal = parlay::sequence<int>(n, -1); // arc towards the least loaded neighbour
+	auto best = parlay::tabulate<std::atomic<long>>(n, [] (long) { return -1L; }); // largest key of a proposer
+	auto given = parlay::sequence<int>(n, 0);
+	auto stamp = parlay::tabulate<std::atomic<int>>(n, [] (long) { return -1; }); // last round in the frontier
+	auto key = [&] (int v) { return L[v]*(long)n + v; };
+	auto frontier = parlay::to_sequence(parlay::iota<int>(n));
+	rounds = moves = 0;
+
+	while (frontier.size() > 0)
+	{
+		// propose
+		auto proposers = parlay::filter(frontier, [&] (int v) {
+			int b = -1;
+			for (long p=first_arc[v]; p<first_arc[v+1]; p++)
+			{
+				int a = arcs[p];
+				if (Capacity(a) > 0 && L[Head(a)] <= L[v] - 2 && (b < 0 || L[Head(a)] < L[Head(b)])) b = a;
+			}
+			proposal[v] = b;
+			return b >= 0;
+		});
+		if (proposers.size() == 0) break;
+		parlay::for_each(proposers, [&] (int v) { parlay::write_max(&best[Head(proposal[v])], key(v), std::less<long>()); });
+
+		// move (an edge is proposed from at most one of its endpoints, so every load[e] changes at most once)
+		auto donors = parlay::filter(proposers, [&] (int v) { return best[Head(proposal[v])].load() == key(v); });
+		parlay::for_each(donors, [&] (int v) {
+			int a = proposal[v];
+			given[v] = (int)std::min((long)Capacity(a), (L[v] - L[Head(a)]) / 2);
+			load[a/2] += (a & 1) ? given[v] : -given[v];
+		});
+		parlay::for_each(donors, [&] (int v) { L[v] -= given[v]; });
+		parlay::for_each(donors, [&] (int v) { L[Head(proposal[v])] += given[v]; });
+		parlay::for_each(proposers, [&] (int v) { best[Head(proposal[v])] = -1; });
+		rounds ++;
+		moves += donors.size();
+
+		// the proposers (turned down or not), the receivers, and the neighbours that can now move a unit to a donor
+		auto touched = parlay::append(proposers, parlay::append(parlay::map(donors, [&] (int v) { return Head(proposal[v]); }),
+			parlay::flatten(parlay::map(donors, [&] (int v) {
+				return parlay::filter(parlay::delayed_tabulate(first_arc[v+1] - first_arc[v], [&, v] (long p) {
+					int a = arcs[first_arc[v] + p] ^ 1; // from the neighbour to v
+					return (Capacity(a) > 0 && L[Tail(a)] >= L[v] + 2) ? Tail(a) : -1;
+				}), [] (int u) { return u >= 0; });
+			}))));
+		frontier = parlay::filter(touched, [&] (int v) {
+			int s = stamp[v].load();
+			return s != (int)rounds && stamp[v].compare_exchange_strong(s, (int)rounds);
+		});
+	}
+
+	return parlay::reduce(L, parlay::maximum<long>());
+}
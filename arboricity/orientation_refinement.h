@@ -0,0 +1,47 @@
+#ifndef __ORIENTATION_REFINEMENT_H__
+#define __ORIENTATION_REFINEMENT_H__
+
+#include <atomic>
+#include <utility>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Flow-free upper bound on k0, the minimal max-indegree of an orientation (see UndirectedGraph::Solve0()).
+//
+// The orientation is integral and kept as in OrientationFlow: edge e gives load[e] units of its weight to its first
+// endpoint and weight[e]-load[e] to the second one, and vertex v has load L(v), the sum of its units. Refine() moves
+// units along single edges until the orientation is locally fair, i.e. no edge has a unit on an endpoint v whose load
+// exceeds the load of the other endpoint u by 2 or more. Every round, each vertex v that has such an edge proposes the
+// one towards its least loaded neighbour, every vertex u accepts the proposal of its most loaded proposer, and v moves
+// min(units of v, (L(v)-L(u))/2) units to u. A vertex gives and receives at most once per round, which makes every round
+// decrease sum_v L(v)^2, so Refine() terminates. Only the vertices next to a change are looked at in the next round.
+//
+// A locally fair orientation is not always optimal (a longer path may still lower the maximum), so the result is an
+// upper bound; the lower bounds come from dense subgraphs, see ApproximateArboricity::ComputeDensity().
+class OrientationRefinement
+{
+public:
+	// ends[e] and weight[e] for e\in[0,edge_num-1] describe the edges, share[e]\in[0,weight[e]] is the initial load of
+	// ends[e].first; the arrays are copied (in parallel)
+	void Init(int node_num, int edge_num, const std::pair<int,int>* ends, const int* weight, const int* share);
+
+	long Refine(); // returns the largest load
+	int GetShare(int e, int d) { return (d == 0) ? load[e] : weight[e] - load[e]; } // units of edge e on ends[e].first (d=0) or .second (d=1)
+
+	long rounds, moves; // statistics of the last Refine()
+
+private:
+	int n, m;
+
+	parlay::sequence<std::pair<int,int>> ends;
+	parlay::sequence<int> weight, load; // per edge
+	parlay::sequence<long> first_arc; // the arcs of v are arcs[first_arc[v]..first_arc[v+1]-1]
+	parlay::sequence<int> arcs; // arc 2*e+d leaves the d'th endpoint of e
+	parlay::sequence<long> L; // per vertex
+
+	int Tail(int a) { return (a & 1) ? ends[a/2].second : ends[a/2].first; }
+	int Head(int a) { return (a & 1) ? ends[a/2].first : ends[a/2].second; }
+	int Capacity(int a) { return GetShare(a/2, a & 1); } // units that the arc can move from its tail to its head
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "arboricity.h"
+#include "approximate.h"
+#include "orientation_refinement.h"
+
+// k0 (the pseudoarboricity of the weighted graph) is the minimal max-indegree of an orientation, and forest_num is k0 or k0+1.
+// The degeneracy orientation (every edge charged to the endpoint peeled first, so at most 'degeneracy' per node) is refined
+// into a locally fair one, whose max-indegree bounds k0 from above. On the other side k0 >= ceil(m(S)/|S|) for every
+// subgraph S, and the dense subgraphs are searched by ComputeDensity() only while they could still meet the upper bound.
+int UndirectedGraph::RefineOrientation()
+{
+	ComputeOrientation();
+	ApproximateArboricity& A = *orientation;
+
+	OrientationRefinement R;
+	{
+		auto ends = parlay::tabulate(user_edge_num, [&] (EdgeId e) { return std::make_pair(edges[2*e].i[0], edges[2*e].i[1]); });
+		auto weights = parlay::tabulate(user_edge_num, [&] (EdgeId e) { return edges[2*e].weight; });
+		auto share = parlay::tabulate(user_edge_num, [&] (EdgeId e) { return (A.tail[e] == edges[2*e].i[0]) ? edges[2*e].weight : 0; });
+		R.Init(node_num, user_edge_num, ends.data(), weights.data(), share.data());
+	}
+	int upper = (int)R.Refine();
+
+	int lower = k0_lower;
+	if (upper > lower)
+	{
+		A.ComputeDensity(0, refinement_iterations, upper - 1);
+		lower = std::max(lower, (int)ceil(A.density_lower));
+	}
+	delete orientation;
+	orientation = NULL;
+
+	k0_lower = std::max(k0_lower, lower);
+	k0_upper = std::min(k0_upper, upper);
+	if (k0_lower < k0_upper) return -1;
+
+	// as in Solve0(): edges[2e] is directed towards edges[2e].i[1] and gets the units of that endpoint
+	parlay::parallel_for(0, user_edge_num, [&] (EdgeId e)
+	{
+		edges[2*e+1].weight = R.GetShare(e, 0);
+		edges[2*e  ].weight = R.GetShare(e, 1);
+	});
+	return k0_upper;
+}
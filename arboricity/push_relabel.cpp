@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "push_relabel.h"
+
+void PushRelabel::SetCapacity(ArcId a, int c)
+{
+	ArcId p = position[2*a];
+	cap[p] = c;
+	if (flow[p] > c)
+	{
+		int d = flow[p] - c;
+		flow[p] = c;
+		flow[partner[p]] = -c;
+		excess[head[partner[p]]] += d; // the tail of a
+		if (head[p] != sink) excess[head[p]] -= d; // the sink's excess is recomputed by Maxflow()
+	}
+}
+
+bool PushRelabel::Discharge(NodeId i, parlay::sequence<NodeId>& pushed)
+{
+	int e = excess[i];
+	long& a = current[i];
+	for ( ; a<first_arc[i+1]; a++)
+	{
+		NodeId j = head[a];
+		if (label[i] != label[j] + 1) continue; // checked first: arcs towards higher labels may be modified concurrently
+		int r = cap[a] - flow[a];
+		if (r <= 0) continue;
+		int d = std::min(r, e);
+		flow[a] += d;
+		flow[partner[a]] -= d;
+		new_excess[j] += d;
+		pushed.push_back(j);
+		e -= d;
+		if (e == 0) break;
+	}
+	excess[i] = e;
+	return e > 0;
+}
+
+void PushRelabel::CountLabels()
+{
+	auto counts = parlay::histogram_by_index(label, n+1);
+	parlay::parallel_for(0, n+1, [&] (int d) { label_count[d] = counts[d]; });
+}
+
+void PushRelabel::Gap(int g)
+{
+	// nodes above an empty label cannot reach the sink any more
+	parlay::parallel_for(0, n, [&] (NodeId i) { if (label[i] > g && label[i] < n) label[i] = n; });
+	CountLabels();
+}
+
+void PushRelabel::GlobalRelabel()
+{
+	// BFS from the sink over reverse residual arcs
+	auto dist = parlay::tabulate<std::atomic<int>>(n, [&] (NodeId i) { return (i == sink) ? 0 : n; });
+	parlay::sequence<NodeId> frontier(1, sink);
+	int level = 0;
+	while (frontier.size() > 0)
+	{
+		level ++;
+		frontier = parlay::flatten(parlay::map(frontier, [&] (NodeId w) {
+			auto found = parlay::tabulate(first_arc[w+1] - first_arc[w], [&] (long k) -> NodeId {
+				long a = first_arc[w] + k;
+				NodeId j = head[a];
+				ArcId p = partner[a]; // j -> w
+				int expected = n;
+				if (cap[p] - flow[p] > 0 && dist[j].load() == n && dist[j].compare_exchange_strong(expected, level)) return j;
+				return -1;
+			});
+			return parlay::filter(found, [] (NodeId j) { return j >= 0; });
+		}));
+	}
+
+	parlay::parallel_for(0, n, [&] (NodeId i) {
+		label[i] = dist[i];
+		current[i] = first_arc[i];
+	});
+	CountLabels();
+
+	active = parlay::filter(parlay::iota<NodeId>(n), [&] (NodeId i) { return i != sink && excess[i] > 0 && label[i] < n; });
+}
+
+long PushRelabel::Maxflow(const std::atomic<bool>* stop)
+{
+	// the flow into the sink (SetCapacity() may have reduced it)
+	excess[sink] = -parlay::reduce(parlay::delayed_tabulate(first_arc[sink+1] - first_arc[sink], [&] (long k) {
+		return (long)flow[first_arc[sink] + k];
+	}));
+
+	GlobalRelabel();
+	long relabels = 0;
+
+	while (active.size() > 0)
+	{
+		// push, using the labels from the beginning of the round
+		parlay::sequence<parlay::sequence<NodeId>> pushed(active.size());
+		auto must_relabel = parlay::tabulate(active.size(), [&] (size_t k) { return Discharge(active[k], pushed[k]); });
+
+		// relabel once all pushes are done, so that the residual capacities are final
+		auto relabeled = parlay::pack(active, must_relabel);
+		parlay::for_each(relabeled, [&] (NodeId i) {
+			int d = n - 1;
+			for (long a=first_arc[i]; a<first_arc[i+1]; a++)
+			{
+				if (cap[a] - flow[a] > 0) d = std::min(d, label[head[a]]);
+			}
+			new_label[i] = d + 1;
+			current[i] = first_arc[i];
+		});
+		auto old_label = parlay::map(relabeled, [&] (NodeId i) {
+			int d = label[i];
+			label[i] = new_label[i];
+			label_count[d] --;
+			label_count[label[i]] ++;
+			return d;
+		});
+		int gap = parlay::reduce(parlay::map(old_label, [&] (int d) { return (label_count[d] == 0) ? d : n; }), parlay::minimum<int>());
+		if (gap < n) Gap(gap);
+		relabels += relabeled.size();
+
+		// the next active set: nodes that received excess and nodes that still have excess
+		auto candidates = parlay::append(parlay::flatten(pushed), active);
+		auto next = parlay::filter(candidates, [&] (NodeId i) { return !queued[i].load() && !queued[i].exchange(true); });
+		parlay::for_each(next, [&] (NodeId i) {
+			excess[i] += new_excess[i].exchange(0);
+			queued[i] = false;
+		});
+		active = parlay::filter(next, [&] (NodeId i) { return i != sink && excess[i] > 0 && label[i] < n; });
+
+		if (relabels > n) { GlobalRelabel(); relabels = 0; }
+		if (stop && stop->load()) return -1;
+	}
+
+	return excess[sink];
+}
+
+void PushRelabel::GetSourceSide(char* side)
+{
+	// BFS over residual arcs from the nodes with excess (the arcs from the implicit source are saturated)
+	auto reached = parlay::tabulate<std::atomic<bool>>(n, [&] (NodeId i) { return i != sink && excess[i] > 0; });
+	auto frontier = parlay::filter(parlay::iota<NodeId>(n), [&] (NodeId i) { return reached[i].load(); });
+	while (frontier.size() > 0)
+	{
+		frontier = parlay::flatten(parlay::map(frontier, [&] (NodeId i) {
+			auto found = parlay::tabulate(first_arc[i+1] - first_arc[i], [&] (long k) -> NodeId {
+				long a = first_arc[i] + k;
+				NodeId j = head[a];
+				if (cap[a] - flow[a] > 0 && !reached[j].load() && !reached[j].exchange(true)) return j;
+				return -1;
+			});
+			return parlay::filter(found, [] (NodeId j) { return j >= 0; });
+		}));
+	}
+	parlay::parallel_for(0, n, [&] (NodeId i) { side[i] = reached[i].load() ? 1 : 0; });
+}
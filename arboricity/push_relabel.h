@@ -0,0 +1,106 @@
+#ifndef __PUSH_RELABEL_H__
+#define __PUSH_RELABEL_H__
+
+#include <atomic>
+#include <tuple>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Parallel synchronous push-relabel max-flow, following parlaylib/examples/push_relabel_max_flow.h
+// (Baumstark, Blelloch and Shun, "Efficient Implementation of a Synchronous Parallel Push-Relabel Algorithm", ESA 2015),
+// with global relabeling by parallel BFS and the gap heuristic.
+//
+// There is no explicit source: flow enters the network as excess given by AddExcess(), and Maxflow() pushes as much
+// of it as possible to the sink (a maximum preflow, whose value equals the max-flow value). Excess that cannot reach the
+// sink stays where it is, so the network can be modified with SetCapacity()/AddExcess() and Maxflow() called again,
+// continuing from the current flow.
+class PushRelabel
+{
+public:
+	typedef int NodeId;
+	typedef long ArcId;
+
+	// arc(a) for a\in[0,arc_num-1] must return std::tuple<NodeId,NodeId,int> (tail, head, capacity).
+	// Arc a can later be referred to by its id a. A residual reverse arc is created for every arc.
+	template <class F> void Init(int node_num, ArcId arc_num, NodeId sink, F arc);
+
+	void AddExcess(NodeId i, int x) { excess[i] += x; }
+	void SetCapacity(ArcId a, int cap); // if the flow exceeds the new capacity, the difference becomes excess at the tail. Thread-safe for distinct tails
+	int GetFlow(ArcId a) { return flow[position[2*a]]; }
+
+	long Maxflow(const std::atomic<bool>* stop = NULL); // returns the total flow into the sink, or -1 if *stop was set (checked every round)
+	// side[i] = 1 for the nodes reachable from a node with excess in the residual network, 0 for the others (side has node_num entries).
+	// After a complete Maxflow() these nodes, with the source, are the source side of a minimum cut
+	void GetSourceSide(char* side);
+
+private:
+	int n;
+	NodeId sink;
+
+	// arcs in CSR form, sorted by tail: the arcs of i are [first_arc[i], first_arc[i+1])
+	parlay::sequence<long> first_arc;
+	parlay::sequence<NodeId> head;
+	parlay::sequence<int> cap, flow;
+	parlay::sequence<ArcId> partner;
+	parlay::sequence<ArcId> position; // position[2*a] / position[2*a+1]: user arc a / its reverse
+
+	parlay::sequence<int> excess, label, new_label;
+	parlay::sequence<std::atomic<int>> new_excess; // excess received in the current round
+	parlay::sequence<long> current; // current-arc pointers
+	parlay::sequence<std::atomic<bool>> queued; // whether the node is in the next active set
+	parlay::sequence<std::atomic<int>> label_count; // number of nodes with each label (labels are in [0,n], n means "cannot reach the sink")
+
+	parlay::sequence<NodeId> active;
+
+	bool Discharge(NodeId i, parlay::sequence<NodeId>& pushed); // returns true if i must be relabeled
+	void GlobalRelabel();
+	void CountLabels();
+	void Gap(int g);
+};
+
+template <class F> void PushRelabel::Init(int node_num, ArcId arc_num, NodeId _sink, F arc)
+{
+	n = node_num;
+	sink = _sink;
+
+	// 2*a is arc a, 2*a+1 its reverse
+	auto tails = parlay::tabulate(2*arc_num, [&] (ArcId b) {
+		auto [i, j, c] = arc(b/2);
+		return (b & 1) ? j : i;
+	});
+	auto order = parlay::integer_sort(parlay::iota<ArcId>(2*arc_num), [&] (ArcId b) { return (unsigned)tails[b]; });
+	position = parlay::sequence<ArcId>(2*arc_num);
+	parlay::parallel_for(0, 2*arc_num, [&] (ArcId p) { position[order[p]] = p; });
+
+	head = parlay::sequence<NodeId>(2*arc_num);
+	cap = parlay::sequence<int>(2*arc_num);
+	flow = parlay::sequence<int>(2*arc_num, 0);
+	partner = parlay::sequence<ArcId>(2*arc_num);
+	parlay::parallel_for(0, 2*arc_num, [&] (ArcId p) {
+		ArcId b = order[p];
+		auto [i, j, c] = arc(b/2);
+		head[p] = (b & 1) ? i : j;
+		cap[p] = (b & 1) ? 0 : c;
+		partner[p] = position[b ^ 1];
+	});
+
+	if (arc_num == 0) first_arc = parlay::sequence<long>(n+1, 0L); // parlay::histogram_by_index() divides by zero on an empty input
+	else
+	{
+		auto counts = parlay::histogram_by_index(tails, (long)n);
+		long total;
+		std::tie(first_arc, total) = parlay::scan(counts);
+		first_arc.push_back(total);
+	}
+
+	excess = parlay::sequence<int>(n, 0);
+	label = parlay::sequence<int>(n, 0);
+	new_label = parlay::sequence<int>(n, 0);
+	new_excess = parlay::sequence<std::atomic<int>>(n);
+	current = parlay::sequence<long>(n, 0);
+	queued = parlay::sequence<std::atomic<bool>>(n);
+	label_count = parlay::sequence<std::atomic<int>>(n+1);
+	parlay::parallel_for(0, n, [&] (NodeId i) { new_excess[i] = 0; queued[i] = false; });
+}
+
+#endif
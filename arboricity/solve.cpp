@@ -1,39 +1,72 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
 #include "arboricity.h"
 
 
 int UndirectedGraph::ComputeForests(int k_current)
 {
 	int i;
-	Edge* e;
 
-	forests = new SpanningForest*[k_current];
 	forest_num = 0;
+	parent_arena.Init(node_num + 1);
 
 	for (i=0; i<=node_num; i++)
 	{
 		nodes[i].incoming = 0;
 	}
+	if (!RestoreForests(&k_current))
+	{
+		forests = new SpanningForest*[k_current];
+		SeedForests(k_current);
+	}
+	bool seeded = (forest_num > 0); // then sweep the seeded (or restored) forests before adding one
 
-	queue.Init();
-	for (e=edges; e<edges+edge_num+node_num; e++) e->path_parent = PP_NO_PARENT;
+	bool parallel = (parlay::num_workers() > 1 && forest_type == FOREST_PARENT_POINTERS);
+	workspace_num = (parallel) ? parlay::num_workers() : 1;
+	workspaces = new SearchWorkspace*[workspace_num];
+	for (i=0; i<workspace_num; i++) workspaces[i] = new SearchWorkspace(edge_num, node_num);
 
 	while ( 1 )
 	{
-		if (forest_num == k_current)
+		if (TimeBudgetExceeded()) { DeleteWorkspaces(); WriteCheckpoint(CHECKPOINT_FORESTS, k_current); return -1; }
+
+		if (seeded) seeded = false;
+		else
 		{
-			for (i=0; i<node_num; i++) { if (nodes[i].incoming < forest_num) break; }
-			if (i == node_num) return forest_num;
-			k_current ++;
-			for (i=0; i<node_num; i++) edges[i+edge_num].weight ++;
-			SpanningForest** forests_old = forests;
-			forests = new SpanningForest*[k_current];
-			memcpy(forests, forests_old, forest_num*sizeof(SpanningForest*));
-			delete [] forests_old;
+			if (forest_num == k_current)
+			{
+				for (i=0; i<node_num; i++) { if (nodes[i].incoming < forest_num) break; }
+				if (i == node_num)
+				{
+					DeleteWorkspaces();
+					for (i=0; i<forest_num; i++) forests[i]->UpdateParents();
+					WriteCheckpoint(CHECKPOINT_FORESTS, k_current);
+					return forest_num;
+				}
+				k_current ++;
+				if (stats) stats->forest_growths ++;
+				for (i=0; i<node_num; i++) edges[i+edge_num].weight ++;
+				SpanningForest** forests_old = forests;
+				forests = new SpanningForest*[k_current];
+				memcpy(forests, forests_old, forest_num*sizeof(SpanningForest*));
+				delete [] forests_old;
+			}
+
+			EdgeId* parents = parent_arena.Allocate();
+			if (forest_type == FOREST_LINK_CUT) forests[forest_num ++] = new SpanningForest(node_num + 1, nodes, edges, parents, edge_num + node_num);
+			else                                forests[forest_num ++] = new SpanningForest(node_num + 1, nodes, edges, parents);
+			if (stats) stats->forests_added ++;
 		}
 
-		forests[forest_num ++] = new SpanningForest(node_num + 1, nodes);
+		if (parallel)
+		{
+			AugmentParallel(k_current);
+			continue;
+		}
 
 		bool augmentation;
 		do
@@ -43,46 +76,164 @@ int UndirectedGraph::ComputeForests(int k_current)
 			{
 				if (nodes[i].incoming < forest_num)
 				{
-					Edge* e = Search(i);
+					Edge* e = Search(i, workspaces[0]);
 					if (e)
 					{
-						Augment(e);
+						Augment(e, workspaces[0]);
 						augmentation = true;
 					}
 				}
 			}
+			if (CheckpointDue()) WriteCheckpoint(CHECKPOINT_FORESTS, k_current);
 		} while (augmentation);
 	}
 }
 
-void UndirectedGraph::Augment(Edge* e_last)
+// Same sweeps as in ComputeForests(), processed in rounds as in parlaylib/examples/helper/speculative_for.h:
+// the searches of a round run concurrently on the current forests, then their paths are applied one by one in node order.
+// A path can be invalidated by the ones applied before it; Augment() then detects this and the node is carried forward
+// to the next round (as is a node that still has incoming < forest_num after its augmentation).
+// Rounds do not depend on the number of workers, so neither do the forests.
+void UndirectedGraph::AugmentParallel(int k_current)
+{
+	typedef std::pair<Edge*,int> PathStep;
+
+	bool augmentation;
+	do
+	{
+		augmentation = false;
+
+		auto pending = parlay::filter(parlay::iota<NodeId>(node_num), [&] (NodeId i) { return nodes[i].incoming < forest_num; });
+		parlay::sequence<NodeId> carry_forward;
+		long end = pending.size(), number_done = 0, number_keep = 0, round_size = 1;
+
+		while (number_done < end)
+		{
+			long size = std::max(number_keep, std::min(round_size, end - number_done));
+			auto node = [&] (long k) { return (k < number_keep) ? carry_forward[k] : pending[number_done + k]; };
+
+			// search (no nested parallelism here: the workspace belongs to the worker for the whole call)
+			auto paths = parlay::tabulate(size, [&] (long k) {
+				std::vector<PathStep> path;
+				NodeId z = node(k);
+				if (nodes[z].incoming < forest_num)
+				{
+					SearchWorkspace* w = workspaces[parlay::worker_id()];
+					Edge* e = Search(z, w);
+					EdgeId a;
+					for (a=(e) ? (EdgeId)(e-edges) : -1; a>=0; a=w->path_parent_edge[a]) path.push_back(PathStep(&edges[a], w->path_parent[a]));
+					std::reverse(path.begin(), path.end());
+				}
+				return path;
+			}, 1);
+
+			// commit
+			parlay::sequence<bool> keep(size, false);
+			long k, conflicts = 0, committed = 0;
+			for (k=0; k<size; k++)
+			{
+				if (paths[k].empty()) continue; // no augmenting path in the current sweep
+				if (Augment(paths[k].data(), (int)paths[k].size()))
+				{
+					committed ++;
+					keep[k] = (nodes[node(k)].incoming < forest_num);
+				}
+				else
+				{
+					conflicts ++;
+					keep[k] = true;
+				}
+			}
+			if (conflicts > 0 && committed == 0) { printf("Error in AugmentParallel()\n"); exit(1); } // the first path of a round is always valid
+			if (committed > 0) augmentation = true;
+
+			carry_forward = parlay::pack(parlay::tabulate(size, node), keep);
+			number_keep = carry_forward.size();
+			number_done += size - number_keep;
+
+			if (5*conflicts < size) round_size *= 2;
+			else if (2*conflicts > size) round_size = std::max(round_size/2, 1L);
+		}
+		if (CheckpointDue()) WriteCheckpoint(CHECKPOINT_FORESTS, k_current);
+	} while (augmentation);
+}
+
+UndirectedGraph::SearchWorkspace::SearchWorkspace(int edge_num, int node_num)
+{
+	int i;
+	path_parent = new int[edge_num + node_num];
+	path_parent_edge = new EdgeId[edge_num + node_num];
+	lca_flag = new char[node_num + 1];
+	for (i=0; i<edge_num+node_num; i++) path_parent[i] = PP_NO_PARENT;
+	for (i=0; i<=node_num; i++) lca_flag[i] = 0;
+	queue.Init();
+	searches = queue_pushes = lca_steps = 0;
+}
+
+UndirectedGraph::SearchWorkspace::~SearchWorkspace()
+{
+	delete [] path_parent;
+	delete [] path_parent_edge;
+	delete [] lca_flag;
+}
+
+void UndirectedGraph::CollectSearchStats()
+{
+	int i;
+	for (i=0; i<workspace_num; i++)
+	{
+		SearchWorkspace* w = workspaces[i];
+		if (stats)
+		{
+			stats->searches += w->searches;
+			stats->queue_pushes += w->queue_pushes;
+			stats->lca_steps += w->lca_steps;
+		}
+		w->searches = w->queue_pushes = w->lca_steps = 0;
+	}
+}
+
+void UndirectedGraph::DeleteWorkspaces()
+{
+	if (!workspaces) return;
+	int i;
+	CollectSearchStats();
+	for (i=0; i<workspace_num; i++) delete workspaces[i];
+	delete [] workspaces;
+	workspaces = NULL;
+	workspace_num = 0;
+}
+
+void UndirectedGraph::Augment(Edge* e_last, SearchWorkspace* w)
 {
 #ifdef PRINT_DEBUG
 	printf("augmenting path in reverse:");
 #endif
 
-	Edge* e = e_last;
-	Edge* e_next = NULL;
+	// reverse the path in w->path_parent_edge, so that it gives the next edge
+	EdgeId a = (EdgeId)(e_last - edges), a_next = -1;
 	while ( 1 )
 	{
 #ifdef PRINT_DEBUG
-		printf(" (%d,%d)", e->i[0], e->i[1]);
+		printf(" (%d,%d)", edges[a].i[0], edges[a].i[1]);
 #endif
-		Edge* e_prev = e->path_parent_edge;
-		e->path_parent_edge = e_next;
-		e_next = e;
-		if (!e_prev) break;
-		e = e_prev;
+		EdgeId a_prev = w->path_parent_edge[a];
+		w->path_parent_edge[a] = a_next;
+		a_next = a;
+		if (a_prev < 0) break;
+		a = a_prev;
 	}
 #ifdef PRINT_DEBUG
 	printf("\n");
 #endif
 
+	Edge* e = &edges[a];
 	while ( e != e_last )
 	{
 		Edge* g = e;
-		e = e->path_parent_edge;
-		int k = e->path_parent;
+		a = w->path_parent_edge[a];
+		e = &edges[a];
+		int k = w->path_parent[a];
 		if (k >= 0)
 		{
 			if (!forests[k]->isPresent(e))
@@ -119,6 +270,7 @@ void UndirectedGraph::Augment(Edge* e_last)
 			break;
 		}
 	}
+	if (stats) stats->augmentations ++;
 
 #ifdef PRINT_DEBUG
 	for (k=0; k<forest_num; k++)
@@ -128,67 +280,148 @@ void UndirectedGraph::Augment(Edge* e_last)
 #endif
 }
 
-UndirectedGraph::Edge* UndirectedGraph::Search(NodeId z)
+bool UndirectedGraph::Augment(const std::pair<Edge*,int>* path, int len)
 {
-	int _e;
+	int j, k, d;
+	NodeId p;
+
+	// undoes the exchanges of path[1..J-1]
+	auto undo = [&] (int J)
+	{
+		for (j=J-1; j>=1; j--)
+		{
+			Edge* g = path[j-1].first;
+			Edge* e = path[j].first;
+			k = path[j].second;
+			if (k < 0) continue;
+			forests[k]->RemoveEdge(g);
+			g->weight ++;
+			nodes[g->i[1]].incoming --;
+			forests[k]->AddEdge(e, e->i[0]);
+			e->weight --;
+			nodes[e->i[1]].incoming ++;
+		}
+	};
+
+	// exchanges as in Augment(Edge*): e leaves forest k and is replaced by its predecessor g,
+	// which is valid if e is on the cycle that g closes in forest k
+	for (j=1; j<len; j++)
+	{
+		Edge* g = path[j-1].first;
+		Edge* e = path[j].first;
+		k = path[j].second;
+		if (k < 0) continue;
+
+		SpanningForest* F = forests[k];
+		bool valid = false;
+		if (g->weight > 0 && F->isPresent(e) && !F->isPresent(g))
+		{
+			NodeId LCA = F->FindLCA(g);
+			if (LCA >= 0)
+			{
+				for (d=0; d<2 && !valid; d++)
+				for (p=g->i[d]; p != LCA; p=F->GetParent(p))
+				{
+					if (F->parents[p] == (EdgeId)(e - edges)) { valid = true; break; }
+				}
+			}
+		}
+		if (!valid) { undo(j); return false; }
+
+		F->RemoveEdge(e);
+		e->weight ++;
+		nodes[e->i[1]].incoming --;
+
+		F->AddEdge(g, g->i[0]);
+		g->weight --;
+		nodes[g->i[1]].incoming ++;
+	}
+
+	Edge* e = path[len-1].first;
+	if (e->weight > 0)
+	{
+		for (k=forest_num-1; k>=0; k--)
+		{
+			if (forests[k]->isPresent(e)) continue;
+			NodeId LCA = forests[k]->FindLCA(e);
+			if (LCA < 0)
+			{
+				forests[k]->AddEdge(e, e->i[0]);
+				e->weight --;
+				nodes[e->i[1]].incoming ++;
+				if (stats) stats->augmentations ++;
+				return true;
+			}
+		}
+	}
+	undo(len);
+	return false;
+}
+
+UndirectedGraph::Edge* UndirectedGraph::Search(NodeId z, SearchWorkspace* w)
+{
+	EdgeId _e, _g;
 	Edge* e;
-	Edge* g;
-	int k, d, p;
+	int k, p;
+	int* path_parent = w->path_parent;
+	EdgeId* path_parent_edge = w->path_parent_edge;
 
-	queue.Restart();
-	while ((e=queue.Remove())) e->path_parent = PP_NO_PARENT;
-	queue.Init();
+	w->queue.Restart();
+	while ((_e=w->queue.Remove()) >= 0) path_parent[_e] = PP_NO_PARENT;
+	w->queue.Init();
+	w->searches ++;
 
 	for (_e=nodes[z].first_incoming; _e>=0; _e=edges[_e].next_incoming)
 	{
-		e = &edges[_e];
-		if (e->weight)
+		if (edges[_e].weight)
 		{
-			e->path_parent = PP_PARENT_SAME_ENDPOINT;
-			e->path_parent_edge = NULL;
-			queue.Add(e);
+			path_parent[_e] = PP_PARENT_SAME_ENDPOINT;
+			path_parent_edge[_e] = -1;
+			w->queue.Add(_e);
 		}
 	}
 
-	while ((e=queue.Remove()))
+	while ((_e=w->queue.Remove()) >= 0)
 	{
+		e = &edges[_e];
 		for (k=0; k<forest_num; k++)
 		{
 			SpanningForest* F = forests[k];
 			if (!F->isPresent(e))
 			{
-				NodeId LCA = F->FindLCA(e);
+				NodeId LCA = F->FindLCA(e, w->lca_flag, &w->lca_steps);
 				if (LCA < 0)
 				{
+					w->queue_pushes += w->queue.Size();
 					return e; // success - found joining edge
 				}
-				for (d=0; d<2; d++)
+				F->ForEachPathEdge(e, LCA, [&] (Edge* g)
 				{
-					for (p=e->i[d]; p != LCA; p=F->GetParent(p))
+					EdgeId _g = (EdgeId)(g - edges);
+					if (path_parent[_g] == PP_NO_PARENT)
 					{
-						Edge* g = F->parents[p];
-						if (g->path_parent == PP_NO_PARENT)
-						{
-							g->path_parent = k;
-							g->path_parent_edge = e;
-							queue.Add(g);
-						}
+						path_parent[_g] = k;
+						path_parent_edge[_g] = _e;
+						w->queue.Add(_g);
 					}
-				}
+				});
 			}
+			// e may be replaced by any unused copy with the same head, since only the indegrees matter;
+			// not in incremental mode, where every copy must stay covered
+			if (incremental) continue;
 			p = e->i[1];
-			for (_e=nodes[p].first_incoming; _e>=0; _e=edges[_e].next_incoming)
+			for (_g=nodes[p].first_incoming; _g>=0; _g=edges[_g].next_incoming)
 			{
-				g = &edges[_e];
-				if (g->weight && g->path_parent == PP_NO_PARENT)
+				if (edges[_g].weight && path_parent[_g] == PP_NO_PARENT)
 				{
-					g->path_parent = PP_PARENT_SAME_ENDPOINT;
-					g->path_parent_edge = e;
-					queue.Add(g);
+					path_parent[_g] = PP_PARENT_SAME_ENDPOINT;
+					path_parent_edge[_g] = _e;
+					w->queue.Add(_g);
 				}
 			}
 		}
 	}
 
+	w->queue_pushes += w->queue.Size();
 	return NULL;
 }
@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "solve_stats.h"
+
+// time_reductions of the subproblem is already part of the time_reductions of its parent
+void SolveStats::Add(const SolveStats& s)
+{
+	time_bounds += s.time_bounds;
+	time_greedy += s.time_greedy;
+	time_refine += s.time_refine;
+	time_solve0 += s.time_solve0;
+	time_compact += s.time_compact;
+	time_forests += s.time_forests;
+	time_insert += s.time_insert;
+	probes.insert(probes.end(), s.probes.begin(), s.probes.end());
+	searches += s.searches;
+	queue_pushes += s.queue_pushes;
+	lca_steps += s.lca_steps;
+	augmentations += s.augmentations;
+	forests_added += s.forests_added;
+	forest_growths += s.forest_growths;
+	subproblems += 1 + s.subproblems;
+}
+
+void SolveStats::PrintJSON(FILE* fp) const
+{
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"time\": {\"total\": %.6f, \"reductions\": %.6f, \"bounds\": %.6f, \"greedy\": %.6f, \"refine\": %.6f, \"solve0\": %.6f, \"compact\": %.6f, \"forests\": %.6f, \"insert\": %.6f},\n",
+		time_total, time_reductions, time_bounds, time_greedy, time_refine, time_solve0, time_compact, time_forests, time_insert);
+	fprintf(fp, "  \"probes\": [");
+	for (size_t p=0; p<probes.size(); p++)
+	{
+		fprintf(fp, "%s{\"k\": %d, \"flow\": %ld, \"feasible\": %s, \"seconds\": %.6f}", (p > 0) ? ", " : "",
+			probes[p].k, probes[p].flow, probes[p].feasible ? "true" : "false", probes[p].seconds);
+	}
+	fprintf(fp, "],\n");
+	fprintf(fp, "  \"searches\": %ld,\n  \"queue_pushes\": %ld,\n  \"lca_steps\": %ld,\n  \"augmentations\": %ld,\n", searches, queue_pushes, lca_steps, augmentations);
+	fprintf(fp, "  \"forests_added\": %d,\n  \"forest_growths\": %d,\n  \"subproblems\": %d\n", forests_added, forest_growths, subproblems);
+	fprintf(fp, "}\n");
+}
@@ -0,0 +1,38 @@
+#ifndef __SOLVE_STATS_H__
+#define __SOLVE_STATS_H__
+
+#include <stdio.h>
+#include <vector>
+
+// Statistics of UndirectedGraph::Solve(), see UndirectedGraph::SetStats(). The subproblems of the core pruning and of
+// the components are added in, so phase times are summed over them (components may be solved in parallel).
+struct SolveStats
+{
+	SolveStats() : time_total(0), time_reductions(0), time_bounds(0), time_greedy(0), time_refine(0), time_solve0(0), time_compact(0), time_forests(0),
+	               time_insert(0), searches(0), queue_pushes(0), lca_steps(0), augmentations(0), forests_added(0), forest_growths(0),
+	               subproblems(0) {}
+
+	double time_total; // of the top-level Solve()
+	double time_reductions; // SolveCore() and SolveComponents(), including the subproblems they solve
+	double time_bounds, time_greedy, time_refine, time_solve0, time_compact, time_forests; // phases of the monolithic solve
+	double time_insert; // InsertEdges()
+
+	struct Probe
+	{
+		int k;
+		long flow; // -1 if stopped (parallel probing)
+		bool feasible; // k0 <= k
+		double seconds;
+	};
+	std::vector<Probe> probes; // every Maxflow() call of Solve0(), in order
+
+	long searches, queue_pushes, lca_steps, augmentations; // Search() calls, edges queued by them, parent steps of FindLCA()
+	int forests_added; // forests created by ComputeForests() or InsertEdges()
+	int forest_growths; // times ComputeForests() had to go past k0, or InsertEdges() past the previous arboricity
+	int subproblems;
+
+	void Add(const SolveStats& s); // adds the statistics of a subproblem (but not its time_total and time_reductions)
+	void PrintJSON(FILE* fp) const;
+};
+
+#endif
@@ -1,32 +1,69 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 #include "arboricity.h"
 
-UndirectedGraph::SpanningForest::SpanningForest(int _n, Node* _nodes)
-	: n(_n), nodes(_nodes)
+UndirectedGraph::SpanningForest::SpanningForest(int _n, Node* _nodes, Edge* _edges, EdgeId* _parents)
+	: n(_n), nodes(_nodes), edges(_edges), parents(_parents), lct(NULL), edge_node(NULL), slot_edge(NULL), free_slots(NULL), free_slot_num(0)
 {
 	int i;
-	parents = new Edge*[n];
-	for (i=0; i<n; i++) parents[i] = NULL;
+	for (i=0; i<n; i++) parents[i] = -1;
+}
+
+UndirectedGraph::SpanningForest::SpanningForest(int _n, Node* _nodes, Edge* _edges, EdgeId* _parents, int m)
+	: n(_n), nodes(_nodes), edges(_edges), parents(_parents)
+{
+	int i;
+	for (i=0; i<n; i++) parents[i] = -1;
+
+	// a forest on n nodes has at most n-1 edges
+	lct = new LinkCutTree(2*n);
+	edge_node = new int[m];
+	for (i=0; i<m; i++) edge_node[i] = -1;
+	slot_edge = new EdgeId[n];
+	free_slots = new int[n];
+	for (i=0; i<n; i++) free_slots[i] = n-1-i;
+	free_slot_num = n;
 }
 
 UndirectedGraph::SpanningForest::~SpanningForest()
 {
-	delete [] parents;
+	if (lct)
+	{
+		delete lct;
+		delete [] edge_node;
+		delete [] slot_edge;
+		delete [] free_slots;
+	}
 }
 
 UndirectedGraph::NodeId UndirectedGraph::SpanningForest::FindLCA(Edge* e)
+{
+	if (lct) return lct->LCA(e->i[0], e->i[1]);
+	long steps = 0; // not reported
+	return FindLCA(e, [&] (NodeId i) -> char& { return nodes[i].tmp_flag; }, &steps);
+}
+
+UndirectedGraph::NodeId UndirectedGraph::SpanningForest::FindLCA(Edge* e, char* flag, long* steps)
+{
+	if (lct) { (*steps) ++; return lct->LCA(e->i[0], e->i[1]); }
+	return FindLCA(e, [&] (NodeId i) -> char& { return flag[i]; }, steps);
+}
+
+template <class Flag> UndirectedGraph::NodeId UndirectedGraph::SpanningForest::FindLCA(Edge* e, Flag flag, long* steps)
 {
 	NodeId i[2] = { e->i[0], e->i[1] }, p, q, r, LCA;
 	int d = 0;
+	long s = 0;
 
-	nodes[i[0]].tmp_flag = nodes[i[1]].tmp_flag = 1;
+	flag(i[0]) = flag(i[1]) = 1;
 
 	while ( 1 )
 	{
 		p = GetParent(i[d]);
-		if (p < 0 || nodes[p].tmp_flag) break;
-		nodes[p].tmp_flag = 1;
+		s ++;
+		if (p < 0 || flag(p)) break;
+		flag(p) = 1;
 		i[d] = p;
 		d ^= 1;
 	}
@@ -38,10 +75,10 @@ UndirectedGraph::NodeId UndirectedGraph::SpanningForest::FindLCA(Edge* e)
 		r = e->i[d ^ 1];
 		while (r != q)
 		{
-			nodes[r].tmp_flag = 0;
+			flag(r) = 0;
 			r = GetParent(r);
 		}
-		nodes[q].tmp_flag = 0;
+		flag(q) = 0;
 	}
 	else
 	{
@@ -49,55 +86,166 @@ UndirectedGraph::NodeId UndirectedGraph::SpanningForest::FindLCA(Edge* e)
 		while ( 1 )
 		{
 			q = GetParent(q);
-			if (q < 0 || nodes[q].tmp_flag) break;
+			s ++;
+			if (q < 0 || flag(q)) break;
 		}
 		LCA = q;
 		r = e->i[d ^ 1];
 		while (r != qq)
 		{
-			nodes[r].tmp_flag = 0;
+			flag(r) = 0;
 			r = GetParent(r);
 		}
-		nodes[qq].tmp_flag = 0;
+		flag(qq) = 0;
 	}
 
 	r = e->i[d];
 	while (r != p)
 	{
-		nodes[r].tmp_flag = 0;
+		flag(r) = 0;
 		r = GetParent(r);
 	}
-	if (p >= 0) nodes[p].tmp_flag = 0;
+	if (p >= 0) flag(p) = 0;
 
+	*steps += s;
 	return LCA;
 }
 
 void UndirectedGraph::SpanningForest::RemoveEdge(Edge* e)
 {
+	if (lct)
+	{
+		int x = edge_node[e - edges];
+		lct->Cut(e->i[0], x);
+		lct->Cut(x, e->i[1]);
+		edge_node[e - edges] = -1;
+		free_slots[free_slot_num ++] = x - n;
+		return;
+	}
+
 	NodeId p = e->i[0], q = e->i[1];
-	if (parents[p] == e)
+	EdgeId a = (EdgeId)(e - edges);
+	if (parents[p] == a)
 	{
-		parents[p] = NULL;
+		parents[p] = -1;
 	}
 	else
 	{
-		assert(parents[q] == e);
-		parents[q] = NULL;
+		assert(parents[q] == a);
+		parents[q] = -1;
 	}
 }
 
 void UndirectedGraph::SpanningForest::AddEdge(Edge* e, NodeId p)
 {
-	NodeId q = p;
+	if (lct)
+	{
+		int s = free_slots[-- free_slot_num];
+		slot_edge[s] = (EdgeId)(e - edges);
+		edge_node[e - edges] = n + s;
+		lct->Link(n + s, e->i[0]);
+		lct->Link(e->i[1], n + s);
+		return;
+	}
+
+	EdgeId a = (EdgeId)(e - edges);
 	while ( 1 )
 	{
 		NodeId q = GetParent(p);
-		Edge* tmp = e; e = parents[p]; parents[p] = tmp;
+		EdgeId tmp = a; a = parents[p]; parents[p] = tmp;
 		if (q < 0) break;
 		p = q;
 	}
 }
 
+void UndirectedGraph::SpanningForest::UpdateParents()
+{
+	if (!lct) return;
+
+	std::vector<EdgeId> list;
+	int i, s;
+	for (i=0; i<free_slot_num; i++) slot_edge[free_slots[i]] = -1;
+	for (s=0; s<n; s++) if (slot_edge[s] >= 0) list.push_back(slot_edge[s]);
+	BuildParents(list.data(), (int)list.size());
+}
+
+void UndirectedGraph::SpanningForest::SetEdges(const EdgeId* list, int num)
+{
+	if (lct)
+	{
+		int k;
+		for (k=0; k<num; k++) AddEdge(&edges[list[k]], edges[list[k]].i[0]);
+		return;
+	}
+	BuildParents(list, num);
+}
+
+void UndirectedGraph::SpanningForest::BuildParents(const EdgeId* list, int num)
+{
+	// adjacency lists of the forest edges, then BFS from the largest node of every tree
+	std::vector<int> first(n+1, 0), queue;
+	std::vector<EdgeId> adj(2*num);
+	int i, k;
+	for (k=0; k<num; k++) { first[edges[list[k]].i[0]+1] ++; first[edges[list[k]].i[1]+1] ++; }
+	for (i=0; i<n; i++) first[i+1] += first[i];
+	std::vector<int> pos(first.begin(), first.end() - 1);
+	for (k=0; k<num; k++)
+	{
+		adj[pos[edges[list[k]].i[0]] ++] = list[k];
+		adj[pos[edges[list[k]].i[1]] ++] = list[k];
+	}
+
+	std::vector<bool> visited(n, false);
+	for (i=n-1; i>=0; i--)
+	{
+		if (visited[i]) continue;
+		visited[i] = true;
+		parents[i] = -1;
+		queue.assign(1, i);
+		for (k=0; k<(int)queue.size(); k++)
+		{
+			NodeId p = queue[k];
+			int a;
+			for (a=first[p]; a<first[p+1]; a++)
+			{
+				Edge* e = &edges[adj[a]];
+				NodeId q = e->i[ (e->i[0] == p) ? 1 : 0 ];
+				if (visited[q]) continue;
+				visited[q] = true;
+				parents[q] = adj[a];
+				queue.push_back(q);
+			}
+		}
+	}
+}
+
+void UndirectedGraph::ParentArena::Init(int _n)
+{
+	Clear();
+	n = _n;
+}
+
+UndirectedGraph::EdgeId* UndirectedGraph::ParentArena::Allocate()
+{
+	if (used == capacity)
+	{
+		capacity = 1 << block_num;
+		blocks = (EdgeId**) realloc(blocks, (block_num+1)*sizeof(EdgeId*));
+		blocks[block_num ++] = new EdgeId[(long)capacity*n];
+		used = 0;
+	}
+	return blocks[block_num-1] + (long)(used ++)*n;
+}
+
+void UndirectedGraph::ParentArena::Clear()
+{
+	int b;
+	for (b=0; b<block_num; b++) delete [] blocks[b];
+	free(blocks);
+	blocks = NULL;
+	block_num = used = capacity = 0;
+}
+
 void UndirectedGraph::SpanningForest::Print()
 {
 	NodeId k;
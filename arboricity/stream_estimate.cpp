@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include "stream_estimate.h"
+#include "edge_list.h"
+
+bool StreamingArboricity::Compute(const char* filename, double eps, bool symmetric, size_t block_size)
+{
+	EdgeStream S;
+	if (!S.Open(filename, block_size)) return false;
+	parlay::sequence<EdgeStream::Edge> block;
+	auto keep = [&] (const EdgeStream::Edge& e) { return !symmetric || e.first < e.second; };
+
+	// first pass: node_num and edge_num
+	node_num = 0;
+	edge_num = 0;
+	while (S.Next(block))
+	{
+		node_num = std::max(node_num, 1 + parlay::reduce(parlay::delayed_map(block, [] (const EdgeStream::Edge& e) {
+			return std::max(e.first, e.second);
+		}), parlay::maximum<int>()));
+		edge_num += parlay::count_if(block, keep);
+	}
+	if (S.Failed()) return false;
+	malformed_lines = S.malformed_lines;
+	self_loops = S.self_loops;
+	pass_num = 1;
+
+	auto removed = parlay::sequence<int>(node_num, -1); // the pass that removed the node, -1 if it remains
+	auto degree = parlay::sequence<std::atomic<int>>(node_num);
+	lower = upper = 0;
+	density_lower = 0;
+	active_node_num = -1;
+
+	while (true)
+	{
+		parlay::parallel_for(0, node_num, [&] (int i) { degree[i].store(0, std::memory_order_relaxed); });
+		S.Rewind();
+		while (S.Next(block))
+		{
+			parlay::for_each(block, [&] (const EdgeStream::Edge& e) {
+				if (!keep(e) || removed[e.first] >= 0 || removed[e.second] >= 0) return;
+				degree[e.first].fetch_add(1, std::memory_order_relaxed);
+				degree[e.second].fetch_add(1, std::memory_order_relaxed);
+			});
+		}
+		if (S.Failed()) return false;
+		int pass = pass_num ++;
+
+		// the remaining subgraph, without the nodes that lost all their edges
+		auto d = parlay::delayed_tabulate(node_num, [&] (int i) { return (removed[i] < 0) ? (long)degree[i].load(std::memory_order_relaxed) : 0L; });
+		long n1 = parlay::count_if(d, [] (long x) { return x > 0; });
+		long m1 = parlay::reduce(d) / 2;
+		if (active_node_num < 0) active_node_num = (int)n1;
+		if (m1 == 0) break;
+
+		density_lower = std::max(density_lower, (double)m1 / n1);
+		if (n1 >= 2) lower = std::max(lower, (int)((m1 + n1 - 2) / (n1 - 1)));
+		auto peeled = [&] (int i) { return removed[i] < 0 && (double)degree[i].load(std::memory_order_relaxed)*n1 <= (2 + eps)*m1; };
+		upper = std::max(upper, parlay::reduce(parlay::delayed_tabulate(node_num, [&] (int i) {
+			return peeled(i) ? degree[i].load(std::memory_order_relaxed) : 0;
+		}), parlay::maximum<int>()));
+		parlay::parallel_for(0, node_num, [&] (int i) { if (peeled(i)) removed[i] = pass; }); // with the nodes of degree 0
+		if (parlay::all_of(removed, [] (int r) { return r >= 0; })) break;
+	}
+	density_upper = upper;
+	return true;
+}
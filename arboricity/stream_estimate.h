@@ -0,0 +1,38 @@
+#ifndef __STREAM_ESTIMATE_H__
+#define __STREAM_ESTIMATE_H__
+
+#include <stddef.h>
+
+// Semi-streaming version of ApproximateArboricity with eps > 0, for edge-list files too large to load: the edges are never
+// stored, every peeling round is a sequential pass over the file (EdgeStream, parsed in parallel blocks), and the state is
+// O(node_num) words (a round and a degree per node).
+//
+// The first pass finds node_num. Every further pass counts the degree of each remaining node within the remaining subgraph,
+// which has n' nodes and m' edges, and then removes the nodes of degree <= (2+eps)*m'/n' (Bahmani, Kumar and Vassilvitskii,
+// "Densest Subgraph in Streaming and MapReduce", VLDB 2012). At least a fraction eps/(2+eps) of the nodes goes every pass,
+// so there are O(log(n)/eps) passes, and
+//   density_lower = max m'/n' >= (max_S m(S)/|S|) / (2+eps),
+//   lower = max ceil(m'/(n'-1)) <= arboricity,
+//   upper = max degree of a node when it is removed >= arboricity,
+// the last one because orienting every edge away from the endpoint removed first (ties by id) is acyclic with out-degree
+// at most upper. density_upper = upper as well.
+//
+// A duplicate line counts as a parallel edge. The upper bounds stay valid for the simple graph, the lower bounds do not,
+// so the file should list every edge once (with symmetric = true, the lines with a > b are skipped instead).
+class StreamingArboricity
+{
+public:
+	// returns false if the file cannot be read
+	bool Compute(const char* filename, double eps, bool symmetric = false, size_t block_size = (size_t)64 << 20);
+
+	int node_num; // largest node id + 1
+	int active_node_num; // number of nodes with at least one edge
+	long edge_num; // edges counted in the first pass
+	long malformed_lines, self_loops; // skipped
+	int pass_num; // passes over the file, including the first one
+
+	int lower, upper; // lower <= arboricity <= upper
+	double density_lower, density_upper; // bounds on max_S m(S)/|S|
+};
+
+#endif
@@ -1,6 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <parlay/parallel.h>
 #include "arboricity.h"
+#include "approximate.h"
+#include "densest_subgraph.h"
+#include "edge_list.h"
+#include "orientation_refinement.h"
+#include "stream_estimate.h"
 
 struct Problem
 {
@@ -32,6 +40,16 @@ struct Problem
 			AddEdge(i, j, w);
 		}
 	}
+	void AddRandomEdges(int first, int last, int num) // between the nodes [first,last-1], of weight 1 or 2
+	{
+		while ( num -- > 0 )
+		{
+			int i = first + rand() % (last-first);
+			int j = first + rand() % (last-first-1);
+			if (j>=i) j ++;
+			AddEdge(i, j, 1 + (rand() % 2));
+		}
+	}
 
 	struct Edge
 	{
@@ -83,6 +101,25 @@ struct Torus : public Problem
   } 
 };
 
+// hubs 0 and 1 joined to each other and to the b leaves 2..b+1, plus a separate cycle of c nodes, all edges of weight w.
+// Every node has coreness 2w, so the core decomposition only brackets k0 = ceil(w*(2b+1)/(b+2)) by the density of the whole
+// graph from below and by 2w from above.
+struct HubsAndCycle : public Problem
+{
+  HubsAndCycle(int b, int c, int w)
+    : Problem(b+2+c, 2*b+1+c)
+  {
+    this->AddEdge(0, 1, w);
+    for(int i=2; i<b+2; ++i) {
+      this->AddEdge(0, i, w);
+      this->AddEdge(1, i, w);
+    }
+    for(int i=0; i<c; ++i) {
+      this->AddEdge(b+2 + i, b+2 + (i+1)%c, w);
+    }
+  }
+};
+
 void TestDecomposition(Problem* P)
 {
 	int i, e, k;
@@ -127,9 +164,585 @@ void TestDecomposition(Problem* P)
 	delete g;
 }
 
+// max over node sets S with |S|>=2 of ceil(w(S)/(|S|-1)) (Nash-Williams). O(2^n m) complexity.
+int BruteForceArboricity(Problem* P)
+{
+	int S, e, a = 0;
+	for (S=0; S<(1<<P->n); S++)
+	{
+		int size = __builtin_popcount(S);
+		if (size < 2) continue;
+		int w = 0;
+		for (e=0; e<P->m; e++) if (((S >> P->edges[e].i) & 1) && ((S >> P->edges[e].j) & 1)) w += P->edges[e].w;
+		a = std::max(a, (w + size - 2) / (size - 1));
+	}
+	return a;
+}
+
+// max over nonempty node sets S of w(S)/|S|, the density of the densest subgraph. O(2^n m) complexity.
+double BruteForceDensity(Problem* P)
+{
+	int S, e;
+	double d = 0;
+	for (S=1; S<(1<<P->n); S++)
+	{
+		int w = 0;
+		for (e=0; e<P->m; e++) if (((S >> P->edges[e].i) & 1) && ((S >> P->edges[e].j) & 1)) w += P->edges[e].w;
+		d = std::max(d, (double)w / __builtin_popcount(S));
+	}
+	return d;
+}
+
+UndirectedGraph* NewGraph(Problem* P, int user_edge_num_max)
+{
+	UndirectedGraph* g = new UndirectedGraph(P->n, user_edge_num_max);
+	for (int e=0; e<P->m; e++) g->AddEdge(P->edges[e].i, P->edges[e].j, P->edges[e].w);
+	return g;
+}
+
+// checks that forest_num is the arboricity of P and that the forests of g cover every edge of P exactly 'w' times
+void CheckForests(Problem* P, UndirectedGraph* g, int forest_num)
+{
+	int i, j, e, k, steps;
+	if (forest_num != BruteForceArboricity(P)) { printf("Error: %d forests instead of %d\n", forest_num, BruteForceArboricity(P)); exit(1); }
+
+	int* forest = new int[P->n];
+	int* covered = new int[P->m];
+	for (e=0; e<P->m; e++) covered[e] = 0;
+	for (k=0; k<forest_num; k++)
+	{
+		g->GetForestEdges(k, forest);
+		for (i=0; i<P->n; i++)
+		{
+			e = forest[i];
+			if (e < 0) continue;
+			if (e >= P->m || (P->edges[e].i!=i && P->edges[e].j!=i)) { printf("Error: incorrect edge id\n"); exit(1); }
+			covered[e] ++;
+
+			// the path towards a root has at most n-1 edges
+			for (j=i, steps=0; forest[j]>=0; steps++)
+			{
+				if (steps >= P->n) { printf("Error: cycle in forest %d\n", k); exit(1); }
+				e = forest[j];
+				j = (P->edges[e].i == j) ? P->edges[e].j : P->edges[e].i;
+			}
+		}
+	}
+	for (e=0; e<P->m; e++)
+	{
+		if (covered[e] != P->edges[e].w) { printf("Error: incorrect covering\n"); exit(1); }
+	}
+
+	delete [] forest;
+	delete [] covered;
+}
+
+// graphs without an edge of positive weight need no forest
+void TestEdgeless()
+{
+	Problem P(3, 2);
+	P.AddEdge(0, 1, 0);
+	P.AddEdge(1, 2, 0);
+	Problem Q(5, 0);
+	Problem* problems[2] = { &P, &Q };
+	for (Problem* R : problems)
+	{
+		UndirectedGraph* g = NewGraph(R, R->m);
+		CheckForests(R, g, g->Solve());
+		delete g;
+	}
+}
+
+// ComputeForests() with more than one worker uses AugmentParallel(); the reductions are off so that it works on the whole graph
+void TestParallelAugmentation()
+{
+	Problem P(12, 60);
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		UndirectedGraph* g = NewGraph(&P, P.m);
+		g->SetCorePruning(false);
+		g->SetComponentSolving(false);
+		int forest_num;
+		parlay::execute_with_scheduler(4, [&] { forest_num = g->Solve(); });
+		CheckForests(&P, g, forest_num);
+		delete g;
+	}
+}
+
+// the same with link-cut trees instead of parent pointers, on small grids (long paths) and random graphs
+void TestLinkCutForests()
+{
+	GridGraph G(3, 4);
+	Torus T(3, 4);
+	Problem P(12, 60);
+	Problem* problems[3] = { &G, &T, &P };
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		for (Problem* R : problems)
+		{
+			UndirectedGraph* g = NewGraph(R, R->m);
+			g->SetSpanningForestType(UndirectedGraph::FOREST_LINK_CUT);
+			g->SetCorePruning(false);
+			g->SetComponentSolving(false);
+			CheckForests(R, g, g->Solve());
+			delete g;
+		}
+	}
+}
+
+// InsertEdges(): the second half of the edges is inserted after solving the first half, in batches of equal weight,
+// and must give the forest_num of a fresh Solve()
+void TestInsertEdges()
+{
+	int e, e_end;
+	Problem P(12, 60);
+	std::pair<int,int>* ij = new std::pair<int,int>[P.m_max];
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		UndirectedGraph* g = new UndirectedGraph(P.n, P.m);
+		P.m = P.m_max / 2;
+		for (e=0; e<P.m; e++) g->AddEdge(P.edges[e].i, P.edges[e].j, P.edges[e].w);
+		int forest_num = g->Solve();
+		CheckForests(&P, g, forest_num);
+
+		for (e=P.m; e<P.m_max; e=e_end)
+		{
+			for (e_end=e; e_end<P.m_max && P.edges[e_end].w==P.edges[e].w; e_end++) ij[e_end-e] = std::make_pair(P.edges[e_end].i, P.edges[e_end].j);
+			forest_num = g->InsertEdges(e_end-e, ij, P.edges[e].w);
+			P.m = e_end;
+			CheckForests(&P, g, forest_num);
+		}
+
+		UndirectedGraph* h = NewGraph(&P, P.m);
+		if (h->Solve() != forest_num) { printf("Error: InsertEdges() and Solve() differ\n"); exit(1); }
+		delete h;
+		delete g;
+	}
+	delete [] ij;
+}
+
+// checkpoints: Solve() is resumed by a new UndirectedGraph from the checkpoint of a run stopped by the time budget
+// (the bracket or the flow) and of a complete run (the forests)
+void TestCheckpointResume()
+{
+	const char* checkpoint_file = "test_arboricity.ckpt";
+	Problem P(12, 60);
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		for (int complete=0; complete<2; complete++)
+		{
+			for (int resume=0; resume<2; resume++)
+			{
+				UndirectedGraph* g = NewGraph(&P, P.m);
+				g->SetCorePruning(false);
+				g->SetComponentSolving(false);
+				g->SetCheckpoint(checkpoint_file, 0, resume==1);
+				if (!resume && !complete) g->SetTimeBudget(0);
+				int forest_num = g->Solve();
+				if (resume) CheckForests(&P, g, forest_num);
+				delete g;
+			}
+			remove(checkpoint_file);
+		}
+	}
+}
+
+// the max-flow backends of Solve0()
+void TestMaxflowBackends()
+{
+	MaxflowBackend backends[3] = { MAXFLOW_BK, MAXFLOW_PUSH_RELABEL, MAXFLOW_ORIENTATION };
+	Problem P(12, 60);
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		for (MaxflowBackend b : backends)
+		{
+			UndirectedGraph* g = NewGraph(&P, P.m);
+			g->SetMaxflowBackend(b);
+			g->SetCorePruning(false);
+			g->SetComponentSolving(false);
+			CheckForests(&P, g, g->Solve());
+			delete g;
+		}
+	}
+}
+
+// a bracket [14,20] on k0=17: Solve0() gallops and bisects with several probes, all but the first warm-started
+void TestWarmStartedProbes(MaxflowBackend b)
+{
+	HubsAndCycle P(6, 8, 10);
+	UndirectedGraph* g = NewGraph(&P, P.m);
+	g->SetMaxflowBackend(b);
+	g->SetCorePruning(false);
+	g->SetComponentSolving(false);
+	g->SetStats(true);
+	CheckForests(&P, g, g->Solve());
+	if (g->GetStats()->probes.size() < 5) { printf("Error: %d max-flow probes\n", (int)g->GetStats()->probes.size()); exit(1); }
+	delete g;
+}
+
+// SolveComponents(): three random components of 6, 5 and 4 nodes, solved with and without the reduction. Components whose
+// bound rules them out are covered by the degeneracy orientation instead, so not every graph has a subproblem.
+void TestComponents()
+{
+	int subproblems = 0;
+	Problem P(15, 33);
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.m = 0;
+		P.AddRandomEdges(0, 6, 18);
+		P.AddRandomEdges(6, 11, 10);
+		P.AddRandomEdges(11, 15, 5);
+		for (int components=0; components<2; components++)
+		{
+			UndirectedGraph* g = NewGraph(&P, P.m);
+			g->SetCorePruning(false);
+			g->SetComponentSolving(components==1);
+			g->SetStats(true);
+			CheckForests(&P, g, g->Solve());
+			subproblems += g->GetStats()->subproblems;
+			delete g;
+		}
+	}
+	if (subproblems == 0) { printf("Error: no component was solved separately\n"); exit(1); }
+}
+
+// SolveCore(): a random dense core of 6 nodes with a fringe of 8 nodes, each joined by one edge to an earlier node,
+// solved with and without the reduction
+void TestCorePruning()
+{
+	int subproblems = 0;
+	Problem P(14, 28);
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.m = 0;
+		P.AddRandomEdges(0, 6, 20);
+		for (int i=6; i<P.n; i++) P.AddEdge(i, rand() % i, 1);
+		for (int core_pruning=0; core_pruning<2; core_pruning++)
+		{
+			UndirectedGraph* g = NewGraph(&P, P.m);
+			g->SetCorePruning(core_pruning==1);
+			g->SetComponentSolving(false);
+			g->SetStats(true);
+			CheckForests(&P, g, g->Solve());
+			subproblems += g->GetStats()->subproblems;
+			delete g;
+		}
+	}
+	if (subproblems == 0) { printf("Error: the core was never solved separately\n"); exit(1); }
+}
+
+// Solve0Parallel(): four probes at a time under four workers must give the result of the sequential probes, on the wide
+// bracket of HubsAndCycle and on random graphs, with the backends that check the stop flags
+void TestParallelProbes()
+{
+	MaxflowBackend backends[2] = { MAXFLOW_PUSH_RELABEL, MAXFLOW_ORIENTATION };
+	HubsAndCycle H(6, 8, 10);
+	Problem P(12, 60);
+	Problem* problems[2] = { &H, &P };
+	for (int seed=1; seed<=50; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		for (Problem* R : problems)
+		for (MaxflowBackend b : backends)
+		{
+			int forest_num[2];
+			for (int parallel=0; parallel<2; parallel++)
+			{
+				UndirectedGraph* g = NewGraph(R, R->m);
+				g->SetMaxflowBackend(b);
+				g->SetCorePruning(false);
+				g->SetComponentSolving(false);
+				g->SetParallelProbes((parallel) ? 4 : 1);
+				parlay::execute_with_scheduler(4, [&] { forest_num[parallel] = g->Solve(); });
+				CheckForests(R, g, forest_num[parallel]);
+				delete g;
+			}
+			if (forest_num[0] != forest_num[1]) { printf("Error: parallel probes give %d forests instead of %d\n", forest_num[1], forest_num[0]); exit(1); }
+		}
+	}
+}
+
+// ApproximateArboricity: the copies of every edge are in forests [0,upper-1], no forest has a cycle (checked by union-find),
+// lower <= arboricity <= upper, and ComputeDensity() brackets the density of the densest subgraph
+void TestApproximation()
+{
+	int i, e, f;
+	double eps_list[2] = { 0, 0.5 };
+	Problem P(12, 60);
+	int* root = new int[P.n];
+	auto find = [&] (int i) { while (root[i] != i) i = root[i]; return i; };
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		int arboricity = BruteForceArboricity(&P);
+		double density = BruteForceDensity(&P);
+		for (double eps : eps_list)
+		{
+			ApproximateArboricity A;
+			A.Compute(P.n, P.m, [&] (long k) { return std::make_tuple(P.edges[k].i, P.edges[k].j, P.edges[k].w); }, eps);
+			if (A.lower > arboricity || A.upper < arboricity) { printf("Error: arboricity %d outside [%d,%d]\n", arboricity, A.lower, A.upper); exit(1); }
+			for (e=0; e<P.m; e++)
+			{
+				if (A.forest[e] < 0 || A.forest[e] + P.edges[e].w > A.upper) { printf("Error: incorrect forest index\n"); exit(1); }
+			}
+			for (f=0; f<A.upper; f++)
+			{
+				for (i=0; i<P.n; i++) root[i] = i;
+				for (e=0; e<P.m; e++)
+				{
+					if (f < A.forest[e] || f >= A.forest[e] + P.edges[e].w) continue;
+					int r0 = find(P.edges[e].i), r1 = find(P.edges[e].j);
+					if (r0 == r1) { printf("Error: cycle in forest %d\n", f); exit(1); }
+					root[r0] = r1;
+				}
+			}
+
+			A.ComputeDensity(0.1, 100);
+			if (A.density_lower > density + 1e-9 || A.density_upper < density - 1e-9)
+			{
+				printf("Error: density %f outside [%f,%f]\n", density, A.density_lower, A.density_upper);
+				exit(1);
+			}
+		}
+	}
+	delete [] root;
+}
+
+// OrientationRefinement from a random orientation: the result is locally fair (no unit of an edge on an endpoint whose load
+// exceeds the other one's by 2 or more) and its largest load bounds k0 = ceil(max density) from above; and Solve() with the
+// refinement before Solve0()
+void TestOrientationRefinement()
+{
+	int i, e, d;
+	Problem P(12, 60);
+	std::pair<int,int>* ends = new std::pair<int,int>[P.m_max];
+	int* weight = new int[P.m_max];
+	int* share = new int[P.m_max];
+	long* load = new long[P.n];
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		int k0 = (int)ceil(BruteForceDensity(&P));
+		for (e=0; e<P.m; e++)
+		{
+			ends[e] = std::make_pair(P.edges[e].i, P.edges[e].j);
+			weight[e] = P.edges[e].w;
+			share[e] = rand() % (P.edges[e].w + 1);
+		}
+
+		OrientationRefinement R;
+		R.Init(P.n, P.m, ends, weight, share);
+		long upper = R.Refine();
+		if (upper < k0) { printf("Error: refined max-indegree %ld below k0=%d\n", upper, k0); exit(1); }
+
+		for (i=0; i<P.n; i++) load[i] = 0;
+		for (e=0; e<P.m; e++)
+		{
+			if (R.GetShare(e, 0) + R.GetShare(e, 1) != P.edges[e].w) { printf("Error: incorrect shares\n"); exit(1); }
+			load[P.edges[e].i] += R.GetShare(e, 0);
+			load[P.edges[e].j] += R.GetShare(e, 1);
+		}
+		if (*std::max_element(load, load + P.n) != upper) { printf("Error: incorrect largest load\n"); exit(1); }
+		for (e=0; e<P.m; e++)
+		for (d=0; d<2; d++)
+		{
+			int v = (d == 0) ? P.edges[e].i : P.edges[e].j, u = (d == 0) ? P.edges[e].j : P.edges[e].i;
+			if (R.GetShare(e, d) > 0 && load[v] >= load[u] + 2) { printf("Error: orientation is not locally fair\n"); exit(1); }
+		}
+
+		UndirectedGraph* g = NewGraph(&P, P.m);
+		g->SetOrientationRefinement(true);
+		g->SetCorePruning(false);
+		g->SetComponentSolving(false);
+		CheckForests(&P, g, g->Solve());
+		delete g;
+	}
+	delete [] ends;
+	delete [] weight;
+	delete [] share;
+	delete [] load;
+}
+
+// GetDensestSubgraph(): InducedWeight() of the witness S is GetDensestWeight(), and without the reductions its density lies in
+// (k0-1,k0], k0 = ceil(max density). With them, S is the densest of the witnesses of the subproblems, so only m(S)/|S| <= k0.
+void TestDensestSubgraph()
+{
+	Problem P(12, 60);
+	int* S = new int[P.n];
+	for (int seed=1; seed<=100; seed++)
+	{
+		srand(seed);
+		P.GenerateRandom();
+		int k0 = (int)ceil(BruteForceDensity(&P));
+		for (int reductions=0; reductions<2; reductions++)
+		{
+			UndirectedGraph* g = NewGraph(&P, P.m);
+			g->SetCorePruning(reductions==1);
+			g->SetComponentSolving(reductions==1);
+			g->SetDensestSubgraph(true);
+			CheckForests(&P, g, g->Solve());
+			int num = g->GetDensestSubgraph(S);
+			long weight = InducedWeight(P.n, P.m, [&] (long k) { return std::make_tuple(P.edges[k].i, P.edges[k].j, P.edges[k].w); }, S, num);
+			if (num == 0 || weight != g->GetDensestWeight()) { printf("Error: incorrect densest subgraph weight\n"); exit(1); }
+			if (weight > (long)k0*num || (!reductions && weight <= (long)(k0-1)*num))
+			{
+				printf("Error: density %ld/%d outside (%d,%d]\n", weight, num, k0-1, k0);
+				exit(1);
+			}
+			delete g;
+		}
+	}
+	delete [] S;
+}
+
+// StreamingArboricity on a temporary file with every edge of a random simple graph once (or both ways, with symmetric),
+// read in blocks of 64 bytes so that lines cross block boundaries: lower <= arboricity <= upper, and the density bounds
+void TestStreaming()
+{
+	const char* edge_file = "test_arboricity.edges";
+	double eps_list[2] = { 0.1, 1 };
+	Problem P(12, 66);
+	for (int seed=1; seed<=50; seed++)
+	{
+		srand(seed);
+		P.m = 0;
+		for (int i=0; i<P.n; i++)
+		for (int j=i+1; j<P.n; j++)
+		{
+			if (rand() % 2) P.AddEdge(i, j, 1);
+		}
+		int arboricity = BruteForceArboricity(&P);
+		double density = BruteForceDensity(&P);
+		for (int symmetric=0; symmetric<2; symmetric++)
+		{
+			FILE* fp = fopen(edge_file, "w");
+			if (!fp) { printf("Error opening %s\n", edge_file); exit(1); }
+			fprintf(fp, "# %d nodes, %d edges\n", P.n, P.m);
+			for (int e=0; e<P.m; e++)
+			{
+				bool reversed = (rand() % 2) == 1;
+				if (symmetric || reversed) fprintf(fp, "%d %d\n", P.edges[e].j, P.edges[e].i);
+				if (symmetric || !reversed) fprintf(fp, "%d\t%d\n", P.edges[e].i, P.edges[e].j);
+			}
+			fclose(fp);
+			for (double eps : eps_list)
+			{
+				StreamingArboricity S;
+				if (!S.Compute(edge_file, eps, symmetric==1, 64)) { printf("Error reading %s\n", edge_file); exit(1); }
+				if (S.lower > arboricity || S.upper < arboricity) { printf("Error: arboricity %d outside [%d,%d]\n", arboricity, S.lower, S.upper); exit(1); }
+				if (S.density_lower > density + 1e-9 || S.density_upper < density - 1e-9)
+				{
+					printf("Error: density %f outside [%f,%f]\n", density, S.density_lower, S.density_upper);
+					exit(1);
+				}
+			}
+		}
+	}
+	remove(edge_file);
+}
+
+// EdgeList::Load() on a temporary file with comments, duplicates (also reversed), a self-loop, malformed lines and a CRLF line,
+// then AddEdges() of the result after an AddEdge(); and files that leave no edge
+void TestEdgeListLoader()
+{
+	const char* edge_file = "test_arboricity.edges";
+	const char* text = "# comment\n% comment\n\n0 1\n1 0\n0 1\n2 2\n1 3\n3\t1\n4 5x\n-1 2\n5\n3 2\r\n";
+	int expected_edges[3][2] = { { 0, 1 }, { 1, 3 }, { 2, 3 } };
+	int expected_degrees[4] = { 1, 2, 1, 2 };
+	const char* empty_texts[2] = { "", "# no edges\n1 1\n2 2\n" };
+	int e;
+
+	FILE* fp = fopen(edge_file, "w");
+	if (!fp) { printf("Error opening %s\n", edge_file); exit(1); }
+	fputs(text, fp);
+	fclose(fp);
+	EdgeList list;
+	if (!list.Load(edge_file)) { printf("Error reading %s\n", edge_file); exit(1); }
+	if (list.node_num != 4 || list.edges.size() != 3 || list.malformed_lines != 3 || list.self_loops != 1 || list.duplicates != 3
+	 || list.active_node_num != 4 || list.max_degree != 2) { printf("Error: incorrect edge list counts\n"); exit(1); }
+	for (e=0; e<3; e++)
+	{
+		if (list.edges[e].first != expected_edges[e][0] || list.edges[e].second != expected_edges[e][1]) { printf("Error: incorrect edge list\n"); exit(1); }
+	}
+	for (int i=0; i<4; i++)
+	{
+		if (list.degrees[i] != expected_degrees[i]) { printf("Error: incorrect degrees\n"); exit(1); }
+	}
+
+	Problem P(list.node_num, 4);
+	P.AddEdge(0, 2, 1);
+	for (e=0; e<3; e++) P.AddEdge(list.edges[e].first, list.edges[e].second, 2);
+	UndirectedGraph* g = new UndirectedGraph(P.n, P.m);
+	if (g->AddEdge(0, 2, 1) != 0 || g->AddEdges(3, list.edges.data(), 2) != 1) { printf("Error: incorrect edge ids\n"); exit(1); }
+	CheckForests(&P, g, g->Solve());
+	delete g;
+
+	for (const char* empty_text : empty_texts)
+	{
+		fp = fopen(edge_file, "w");
+		if (!fp) { printf("Error opening %s\n", edge_file); exit(1); }
+		fputs(empty_text, fp);
+		fclose(fp);
+		EdgeList empty;
+		if (!empty.Load(edge_file)) { printf("Error reading %s\n", edge_file); exit(1); }
+		if (empty.node_num != 0 || empty.edges.size() != 0 || empty.degrees.size() != 0 || empty.active_node_num != 0 || empty.max_degree != 0)
+		{
+			printf("Error: edges in an edge list without edges\n");
+			exit(1);
+		}
+	}
+	remove(edge_file);
+}
+
 
 int main()
 {
+  printf("Testing edge list loader\n");
+  TestEdgeListLoader();
+  printf("Testing edgeless graphs\n");
+  TestEdgeless();
+  printf("Testing parallel augmentation\n");
+  TestParallelAugmentation();
+  printf("Testing link-cut forests\n");
+  TestLinkCutForests();
+  printf("Testing edge insertion\n");
+  TestInsertEdges();
+  printf("Testing checkpoint resume\n");
+  TestCheckpointResume();
+  printf("Testing max-flow backends\n");
+  TestMaxflowBackends();
+  TestWarmStartedProbes(MAXFLOW_BK);
+  TestWarmStartedProbes(MAXFLOW_PUSH_RELABEL);
+  printf("Testing connected components\n");
+  TestComponents();
+  printf("Testing core pruning\n");
+  TestCorePruning();
+  printf("Testing parallel probes\n");
+  TestParallelProbes();
+  printf("Testing approximate arboricity\n");
+  TestApproximation();
+  printf("Testing orientation refinement\n");
+  TestOrientationRefinement();
+  printf("Testing densest subgraph\n");
+  TestDensestSubgraph();
+  printf("Testing streaming estimate\n");
+  TestStreaming();
+
   // test grid graphs, arboricity should be two
   printf("Testing grid graphs\n");
   for(int n=100; n<=1000; n+=100) {
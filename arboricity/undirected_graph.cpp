@@ -1,7 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
 #include "arboricity.h"
+#include "approximate.h"
 #include "maxflow-v3.04.src/graph.h"
+#include "maxflow_backend.h"
 
 UndirectedGraph::UndirectedGraph(int _node_num, int _user_edge_num_max)
 	: node_num(_node_num), user_edge_num(0), edge_num(0), edge_num_max(2*_user_edge_num_max)
@@ -15,7 +23,36 @@ UndirectedGraph::UndirectedGraph(int _node_num, int _user_edge_num_max)
 		nodes[i].tmp_flag = 0;
 	}
 	forests = NULL;
+	workspaces = NULL;
+	workspace_num = 0;
 	compacting_mapping = NULL;
+	k0_lower = arboricity_lower = 0;
+	k0_upper = arboricity_upper = -1;
+	time_budget = -1;
+	maxflow_backend = MAXFLOW_ORIENTATION;
+	forest_type = FOREST_PARENT_POINTERS;
+	component_solving = true;
+	core_pruning = true;
+	greedy_forests = false;
+	orientation_refinement = false;
+	refinement_iterations = 16;
+	incremental = false;
+	probe_num = 1;
+	stats = NULL;
+	checkpoint_file = NULL;
+	checkpoint_interval = checkpoint_last = 0;
+	checkpoint_resume = false;
+	checkpoint_hash = 0;
+	resumed = NULL;
+	densest_subgraph = false;
+	densest = NULL;
+	densest_num = 0;
+	densest_weight = 0;
+	user_parents = NULL;
+	orientation = NULL;
+	greedy_edges = NULL;
+	greedy_first = NULL;
+	greedy_forest_num = 0;
 }
 
 UndirectedGraph::~UndirectedGraph()
@@ -29,6 +66,15 @@ UndirectedGraph::~UndirectedGraph()
 		delete [] forests;
 	}
 	if (compacting_mapping) delete [] compacting_mapping;
+	if (user_parents) delete [] user_parents;
+	if (orientation) delete orientation;
+	if (greedy_edges) delete [] greedy_edges;
+	if (greedy_first) delete [] greedy_first;
+	if (stats) delete stats;
+	if (checkpoint_file) delete [] checkpoint_file;
+	if (resumed) delete resumed;
+	if (densest) delete [] densest;
+	DeleteWorkspaces();
 }
 
 UndirectedGraph::EdgeId UndirectedGraph::AddEdge(NodeId i, NodeId j, int weight)
@@ -45,6 +91,28 @@ UndirectedGraph::EdgeId UndirectedGraph::AddEdge(NodeId i, NodeId j, int weight)
 	return user_edge_num ++;
 }
 
+UndirectedGraph::EdgeId UndirectedGraph::AddEdges(int num, const std::pair<NodeId,NodeId>* ij, int weight)
+{
+	if (num < 0 || weight < 0) { printf("Incorrect call to AddEdges()\n"); exit(1); }
+	if (edge_num + 2*(long)num > edge_num_max) { printf("too many edges\n"); exit(1); }
+
+	bool ok = parlay::all_of(parlay::make_slice(ij, ij+num), [&] (const std::pair<NodeId,NodeId>& p)
+		{ return p.first>=0 && p.first<node_num && p.second>=0 && p.second<node_num && p.first!=p.second; });
+	if (!ok) { printf("Incorrect call to AddEdges()\n"); exit(1); }
+
+	Edge* E = &edges[edge_num];
+	parlay::parallel_for(0, num, [&] (size_t k)
+	{
+		E[2*k  ].i[0] = ij[k].first;  E[2*k  ].i[1] = ij[k].second; E[2*k  ].weight = weight;
+		E[2*k+1].i[0] = ij[k].second; E[2*k+1].i[1] = ij[k].first;  E[2*k+1].weight = weight;
+	});
+	edge_num += 2*num;
+
+	EdgeId first = user_edge_num;
+	user_edge_num += num;
+	return first;
+}
+
 void UndirectedGraph::Compact()
 {
 	int _e;
@@ -70,20 +138,31 @@ void UndirectedGraph::Compact()
 
 void UndirectedGraph::GetForestEdges(int k, EdgeId* forest)
 {
-	if (!compacting_mapping) { printf("Error: GetForestEdges() can only be called after Solve()\n"); exit(1); }
+	if (!compacting_mapping && !user_parents && !incremental) { printf("Error: GetForestEdges() can only be called after Solve()\n"); exit(1); }
 	if (k<0 || k>=forest_num) { printf("Error in GetForestEdges(): incorrect forest id\n"); exit(1); }
 
 	NodeId i;
+	if (user_parents)
+	{
+		memcpy(forest, user_parents + (long)k*node_num, node_num*sizeof(EdgeId));
+		return;
+	}
 	SpanningForest* F = forests[k];
+	if (incremental)
+	{
+		F->UpdateParents();
+		for (i=0; i<node_num; i++) forest[i] = (F->parents[i] < 0) ? -1 : F->parents[i]/2;
+		return;
+	}
 	
 	// PARALLEL CHANGE
 	#pragma omp parallel for
 	for (i=0; i<node_num; i++)
 	{
-		if (!F->parents[i]) forest[i] = -1;
+		if (F->parents[i] < 0) forest[i] = -1;
 		else
 		{
-			int e = (int)(F->parents[i] - edges);
+			int e = F->parents[i];
 			forest[i] = (e < edge_num) ? compacting_mapping[e] : -1;
 		}
 	}
@@ -91,11 +170,22 @@ void UndirectedGraph::GetForestEdges(int k, EdgeId* forest)
 
 void UndirectedGraph::GetForestParents(int k, EdgeId* forest)
 {
-	if (!compacting_mapping) { printf("Error: GetForestParents() can only be called after Solve()\n"); exit(1); }
+	if (!compacting_mapping && !user_parents && !incremental) { printf("Error: GetForestParents() can only be called after Solve()\n"); exit(1); }
 	if (k<0 || k>=forest_num) { printf("Error in GetForestParents(): incorrect forest id\n"); exit(1); }
 
 	NodeId i;
+	if (user_parents)
+	{
+		// edges[2*e] is still user edge e (Compact() is not called)
+		for (i=0; i<node_num; i++)
+		{
+			EdgeId e = user_parents[(long)k*node_num + i];
+			forest[i] = (e < 0) ? -1 : edges[2*e].i[ (edges[2*e].i[0] == i) ? 1 : 0 ];
+		}
+		return;
+	}
 	SpanningForest* F = forests[k];
+	if (incremental) F->UpdateParents();
 
 	for (i=0; i<node_num; i++)
 	{
@@ -104,6 +194,22 @@ void UndirectedGraph::GetForestParents(int k, EdgeId* forest)
 	}
 }
 
+double UndirectedGraph::GetTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool UndirectedGraph::TimeBudgetExceeded()
+{
+	return time_budget >= 0 && GetTime() - solve_start > time_budget;
+}
+
+double UndirectedGraph::TimeLeft()
+{
+	if (time_budget < 0) return -1;
+	return std::max(0.0, time_budget - (GetTime() - solve_start));
+}
+
 void UndirectedGraph::PrintEGraph()
 {
 	int e;
@@ -119,66 +225,187 @@ void UndirectedGraph::PrintEGraph()
 
 int UndirectedGraph::Solve0()
 {
-	typedef Graph<int,int,int> G;
+	if (probe_num > 1) return Solve0Parallel();
 
-	G* g = new G(node_num + user_edge_num, user_edge_num);
-	g->add_node(node_num + user_edge_num);
-
-	int i, e;
-	int weight_sum = 0;
-	// PARALLEL CHANGE
-	#pragma omp parallel for reduction(+:weight_sum)
-	for (e=0; e<edge_num; e+=2)
+	long weight_sum;
+	ArboricityMaxflow* g;
+	auto weights = parlay::tabulate(user_edge_num, [&] (int e) { return edges[2*e].weight; });
 	{
-		weight_sum += edges[e].weight;
+		auto ends = parlay::tabulate(user_edge_num, [&] (int e) { return std::make_pair(edges[2*e].i[0], edges[2*e].i[1]); });
+		weight_sum = parlay::reduce(parlay::delayed_map(weights, [] (int w) { return (long)w; }));
+		g = NewArboricityMaxflow(maxflow_backend, node_num, user_edge_num, ends.data(), weights.data());
 	}
 
-	for (e=0; e<edge_num; e+=2)
-	{
-		g->add_tweights(e/2, edges[e].weight, 0);
-		g->add_edge(e/2, edges[e].i[0] + user_edge_num, weight_sum, 0);
-		g->add_edge(e/2, edges[e].i[1] + user_edge_num, weight_sum, 0);
-	}
-
-	int k0_min = 0, k0_max = weight_sum, k_prev = 0, k;
+	// k0 \in [k0_min,k0_max], and k0_max is known to be feasible (see ComputeBounds())
+	int k0_min = std::max(k0_lower, 0), k0_max = (int)std::min((long)k0_upper, weight_sum), k_prev = 0, k_prev_prev = -1, k;
+	int step = 1;
+	bool galloping = true;
 
 	while ( k0_min < k0_max )
 	{
+		if (TimeBudgetExceeded())
+		{
+			k0_lower = k0_min;
+			k0_upper = k0_max;
+			delete g;
+			return -1;
+		}
+		if (CheckpointDue())
+		{
+			k0_lower = k0_min;
+			k0_upper = k0_max;
+			WriteCheckpoint(CHECKPOINT_BRACKET);
+		}
+
 		////////////////////////
 		////// choose k ////////
 		////////////////////////
-		k = k0_min + 2; // do this instead of binary search; with unit capacities may make more sense
-		if (k >= k0_max-1) k = k0_max-1;
+		// The lower bound is usually tight or close, so gallop upwards from it while the probes fail
+		// (when capacities only grow the flow of the previous probe is kept), then bisect what is left.
+		if (galloping) { k = k0_min + step - 1; step *= 2; }
+		else           k = (k0_min + k0_max) / 2;
+		if (k >= k0_max) k = k0_max - 1;
 
 		/////////////////////////////////
 		////// test where k0 > k ////////
 		/////////////////////////////////
-		// PARALLEL CHANGE
-		#pragma omp parallel for
-		for (i=0; i<node_num; i++)
-		{
-			g->add_tweights(i + user_edge_num, 0, k-k_prev);
-		}
+		g->SetSinkCapacity(k); // may decrease when bisecting downwards
+		k_prev_prev = k_prev;
 		k_prev = k;
 
-		int f = g->maxflow();
+		double start = GetTime();
+		long f = g->Maxflow(true);
+		if (stats) stats->probes.push_back({ k, f, f >= weight_sum, GetTime() - start });
 
-		if (f < weight_sum) k0_min = k + 1; // k0 >  k
-		else                k0_max = k;     // k0 <= k
+		if (f < weight_sum) { k0_min = k + 1; if (densest_subgraph) RecordDensest(g, weights.data()); } // k0 >  k
+		else                { k0_max = k; galloping = false; } // k0 <= k
 	}
 
-	// set Edge::weight
-	G::arc_id a = g->get_first_arc();
-	for (e=0; e<edge_num; e+=2)
+	// Finish with the flow at k0, reached from an infeasible probe at k0-1: settling k0-1 first leaves as few
+	// vertex nodes as possible with indegree k0, which makes ComputeForests() considerably cheaper.
+	// These two flows are computed with fresh search trees; reusing them tends to give a less balanced orientation.
+	if (k_prev != k0_min || k_prev_prev != k0_min-1)
 	{
-		a = g->get_next_arc(a); edges[e+1].weight = g->get_rcap(a); a = g->get_next_arc(a);
-		a = g->get_next_arc(a); edges[e  ].weight = g->get_rcap(a); a = g->get_next_arc(a);
+		if (k0_min > 0 && k_prev != k0_min-1)
+		{
+			g->SetSinkCapacity(k0_min-1);
+			k_prev = k0_min-1;
+			double start = GetTime();
+			long f = g->Maxflow(false);
+			if (stats) stats->probes.push_back({ k0_min-1, f, false, GetTime() - start });
+			if (densest_subgraph) RecordDensest(g, weights.data());
+		}
+		g->SetSinkCapacity(k0_min);
+		k_prev = k0_min;
+		double start = GetTime();
+		long f = g->Maxflow(false);
+		if (stats) stats->probes.push_back({ k0_min, f, true, GetTime() - start });
+		if (f < weight_sum) { printf("Error in Solve0(): upper bound is not feasible\n"); exit(1); }
 	}
+
+	// set Edge::weight
+	parlay::parallel_for(0, user_edge_num, [&] (int e)
+	{
+		edges[2*e+1].weight = g->GetFlow(e, 0);
+		edges[2*e  ].weight = g->GetFlow(e, 1);
+	});
 	delete g;
 
 	return k0_min;
 }
 
+// Every round tests the q = min(probe_num, k0_max-k0_min) quantiles k0_min + j*(k0_max-k0_min)/q, j=0..q-1, of the
+// bracket concurrently, each on its own network, which keeps its flow from round to round. A probe that finishes stops the
+// running ones it implies (a feasible k all larger ones, an infeasible k all smaller ones). The two probes that enclose k0
+// imply nothing about each other and always finish, so the bracket after a round does not depend on the timing. The flows
+// do, hence the final flow is computed on a fresh network.
+int UndirectedGraph::Solve0Parallel()
+{
+	auto ends = parlay::tabulate(user_edge_num, [&] (int e) { return std::make_pair(edges[2*e].i[0], edges[2*e].i[1]); });
+	auto weights = parlay::tabulate(user_edge_num, [&] (int e) { return edges[2*e].weight; });
+	long weight_sum = parlay::reduce(parlay::delayed_map(weights, [] (int w) { return (long)w; }));
+
+	int k0_min = std::max(k0_lower, 0), k0_max = (int)std::min((long)k0_upper, weight_sum), j;
+	int P = std::min(probe_num, std::max(k0_max - k0_min, 1));
+	std::vector<ArboricityMaxflow*> g(P);
+	parlay::sequence<std::atomic<bool>> stop(P);
+	for (j=0; j<P; j++)
+	{
+		g[j] = NewArboricityMaxflow(maxflow_backend, node_num, user_edge_num, ends.data(), weights.data());
+		g[j]->SetStopFlag(&stop[j]);
+	}
+
+	while ( k0_min < k0_max )
+	{
+		if (TimeBudgetExceeded()) break;
+		if (CheckpointDue())
+		{
+			k0_lower = k0_min;
+			k0_upper = k0_max;
+			WriteCheckpoint(CHECKPOINT_BRACKET);
+		}
+
+		int range = k0_max - k0_min, q = std::min(P, range);
+		auto probe = parlay::tabulate(q, [&] (int j) { return k0_min + (int)((long)j*range/q); });
+		auto result = parlay::sequence<int>(q, 0); // -1: k0 > probe[j], 1: k0 <= probe[j], 0: stopped
+		auto flow = parlay::sequence<long>(q, -1);
+		auto seconds = parlay::sequence<double>(q, 0);
+		for (j=0; j<q; j++) stop[j] = false;
+
+		parlay::parallel_for(0, q, [&] (int j) {
+			if (stop[j]) return;
+			g[j]->SetSinkCapacity(probe[j]);
+			double start = GetTime();
+			long f = g[j]->Maxflow(true);
+			seconds[j] = GetTime() - start;
+			flow[j] = f;
+			if (f < 0) return;
+			result[j] = (f < weight_sum) ? -1 : 1;
+			for (int l=0; l<q; l++) if ((result[j] > 0) ? (l > j) : (l < j)) stop[l] = true;
+		}, 1);
+
+		for (j=q-1; j>=0; j--) if (result[j] < 0) { if (densest_subgraph) RecordDensest(g[j], weights.data()); break; }
+		for (j=0; j<q; j++)
+		{
+			if (result[j] < 0) k0_min = std::max(k0_min, probe[j] + 1);
+			if (result[j] > 0) k0_max = std::min(k0_max, probe[j]);
+			if (stats) stats->probes.push_back({ probe[j], flow[j], result[j] > 0, seconds[j] });
+		}
+	}
+	for (j=0; j<P; j++) delete g[j];
+	if (k0_min < k0_max)
+	{
+		k0_lower = k0_min;
+		k0_upper = k0_max;
+		return -1;
+	}
+
+	// as in Solve0(), settle k0-1 first
+	ArboricityMaxflow* h = NewArboricityMaxflow(maxflow_backend, node_num, user_edge_num, ends.data(), weights.data());
+	if (k0_min > 0)
+	{
+		h->SetSinkCapacity(k0_min-1);
+		double start = GetTime();
+		long f = h->Maxflow(false);
+		if (stats) stats->probes.push_back({ k0_min-1, f, false, GetTime() - start });
+		if (densest_subgraph) RecordDensest(h, weights.data());
+	}
+	h->SetSinkCapacity(k0_min);
+	double start = GetTime();
+	long f = h->Maxflow(false);
+	if (stats) stats->probes.push_back({ k0_min, f, true, GetTime() - start });
+	if (f < weight_sum) { printf("Error in Solve0Parallel(): upper bound is not feasible\n"); exit(1); }
+
+	parlay::parallel_for(0, user_edge_num, [&] (int e)
+	{
+		edges[2*e+1].weight = h->GetFlow(e, 0);
+		edges[2*e  ].weight = h->GetFlow(e, 1);
+	});
+	delete h;
+
+	return k0_min;
+}
+
 void UndirectedGraph::ComputeSourceCapacities(int k)
 {
 	int i, e;
@@ -231,14 +458,71 @@ bool UndirectedGraph::CheckWithMaxflow(int k)
 	return true;
 }
 
+void UndirectedGraph::SetStats(bool b)
+{
+	if (b && !stats) stats = new SolveStats;
+	if (!b && stats) { delete stats; stats = NULL; }
+}
+
 int UndirectedGraph::Solve()
 {
-	int i, k0, k;
+	solve_start = GetTime();
+	StartCheckpoints();
+	int k = SolvePhases();
+	if (resumed) { delete resumed; resumed = NULL; }
+	if (stats) stats->time_total = GetTime() - solve_start;
+	return k;
+}
 
-	k0 = Solve0();
+int UndirectedGraph::SolvePhases()
+{
+	int i, k0, k;
+	double t = solve_start;
+	auto lap = [&] (double SolveStats::*phase) // adds the time since the previous lap to the given phase
+	{
+		double now = GetTime();
+		if (stats) stats->*phase += now - t;
+		t = now;
+	};
+
+	k = -2;
+	if (core_pruning) k = SolveCore();
+	if (k == -2 && component_solving) k = SolveComponents();
+	if (orientation) { delete orientation; orientation = NULL; }
+	lap(&SolveStats::time_reductions);
+	if (k != -2) return k;
+	ComputeBounds();
+	lap(&SolveStats::time_bounds);
+	if (greedy_forests) ComputeGreedyForests();
+	lap(&SolveStats::time_greedy);
+
+	k0 = RestoreFlow();
+	if (k0 < 0)
+	{
+		if (orientation_refinement) k0 = RefineOrientation();
+		lap(&SolveStats::time_refine);
+		if (k0 < 0) k0 = Solve0();
+		if (k0 < 0) WriteCheckpoint(CHECKPOINT_BRACKET);
+		else
+		{
+			k0_lower = k0_upper = k0;
+			WriteCheckpoint(CHECKPOINT_FLOW);
+		}
+	}
+	if (k0 >= 0) ComputeDensest(k0, resumed == NULL); // without a witness from Solve0(); a checkpoint with the forests keeps the user weights
+	lap(&SolveStats::time_solve0);
+	if (k0 < 0)
+	{
+		arboricity_lower = std::max(arboricity_lower, k0_lower);
+		arboricity_upper = std::min(arboricity_upper, k0_upper+1);
+		return -1;
+	}
 	// printf(" k0=%d ", k0);
+	arboricity_lower = std::max(arboricity_lower, k0);
+	arboricity_upper = std::min(arboricity_upper, k0+1);
 
-	Compact();
+	if (resumed) RestoreCompacted(); // the checkpoint has the forests
+	else         Compact();
 
 	// add edges from the source (=node_num) to every node
 	for (i=0; i<node_num; i++)
@@ -249,6 +533,7 @@ int UndirectedGraph::Solve()
 		edges[i + edge_num].next_incoming = nodes[i].first_incoming;
 		nodes[i].first_incoming = i + edge_num;
 	}
+	lap(&SolveStats::time_compact);
 
 #ifdef PRINT_DEBUG
 	PrintEGraph();
@@ -265,6 +550,9 @@ int UndirectedGraph::Solve()
 
 	ComputeSourceCapacities(k0);
 	k = ComputeForests(k0);
+	lap(&SolveStats::time_forests);
+	if (k < 0) return -1;
+	arboricity_lower = arboricity_upper = k;
 
 	if (k_check>=0 && k_check != k)
 	{
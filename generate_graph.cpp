@@ -0,0 +1,289 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <omp.h>
+
+#include <parlay/primitives.h>
+#include <parlay/parallel.h>
+#include <parlay/random.h>
+#include <parlay/sequence.h>
+
+#include "parlaylib/examples/helper/graph_utils.h"
+
+// Deterministic parallel generator of test graphs for ./final. Every edge is drawn from its own hash of (seed, index),
+// so the output depends only on the parameters and the seed, not on the number of threads. Duplicate edges and
+// self-loops are removed, and the graph is written in the AdjacencyGraph (.adj) format of ./final and/or as a binary
+// CSR: uint64 n, uint64 2m, uint64 file size, uint64 offsets[n+1], uint32 targets[2m] (the layout of GBBS binary graphs).
+
+typedef std::pair<int,int> Edge;
+
+// uniform in [0,1) from 53 bits of a hash
+static double toUnit(size_t h) {
+	return (double)(h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// RMAT (Kronecker) with 2^scale vertices: graph_utils::rmat_edge() of parlaylib/examples with its default probabilities
+// (a,b,c) = (.5,.15,.15), but with the seeded hash of every edge as the random source instead of an unseeded generator
+parlay::sequence<Edge> rmatGraph(int scale, long m, parlay::random r) {
+	return parlay::tabulate(m, [&](long k) {
+		parlay::random ek = r.fork(k);
+		// rmat_edge() calls g() once per level and passes g on by value, so level b reads the b'th hash
+		auto g = [&ek, b = 0]() mutable { return toUnit(ek.ith_rand(b++)); };
+		return graph_utils<int>::rmat_edge(scale, .5, .15, .15, 0.0, g);
+	});
+}
+
+// Erdos-Renyi G(n,m), m edges drawn uniformly
+parlay::sequence<Edge> gnmGraph(int n, long m, parlay::random r) {
+	return parlay::tabulate(m, [&](long k) {
+		return Edge(r.ith_rand(2*k) % n, r.ith_rand(2*k+1) % n);
+	});
+}
+
+// Barabasi-Albert preferential attachment, every vertex v >= 1 adds d edges. Edge e = v*d + j picks a uniform position
+// among the 2e endpoints of the edges before it; an odd position is the target of an earlier edge, which is resolved the
+// same way (Sanders and Schulz, "Scalable generation of scale-free graphs", 2016), so the edges are generated independently.
+parlay::sequence<Edge> baGraph(int n, int d, parlay::random r) {
+	auto target = [&](long e) {
+		while (e >= d) {
+			long p = r.ith_rand(e) % (2*e);
+			if (p % 2 == 0) return (int)(p / 2 / d);
+			e = p / 2;
+		}
+		return 0;
+	};
+	return parlay::tabulate((long)n * d, [&](long e) {
+		return Edge((int)(e / d), target(e));
+	});
+}
+
+// rows x cols grid, like GridGraph in arboricity/test_arboricity.cpp: no triangles, arboricity 2
+parlay::sequence<Edge> gridGraph(int rows, int cols) {
+	auto right = parlay::tabulate((long)rows * (cols - 1), [&](long k) {
+		int i = k / (cols - 1), j = k % (cols - 1);
+		return Edge(i*cols + j, i*cols + j + 1);
+	});
+	auto down = parlay::tabulate((long)(rows - 1) * cols, [&](long k) {
+		return Edge(k, k + cols);
+	});
+	return parlay::append(right, down);
+}
+
+// A random bipartite graph with m edges between two halves of n vertices, which has no triangles, plus 'cliques'
+// disjoint cliques of c further vertices; vertex ids are permuted. The graph has exactly cliques*C(c,3) triangles, and
+// its arboricity is at least ceil(c/2), the arboricity of K_c.
+parlay::sequence<Edge> plantedGraph(int n, long m, int cliques, int c, parlay::random r) {
+	int half = n / 2;
+	auto background = parlay::tabulate(m, [&](long k) {
+		return Edge(r.ith_rand(2*k) % half, half + r.ith_rand(2*k+1) % (n - half));
+	});
+	long pairs = (long)c * (c - 1) / 2;
+	auto planted = parlay::tabulate(cliques * pairs, [&](long k) {
+		long q = k / pairs, p = k % pairs;
+		int a = 0;
+		while (p >= c - 1 - a) { p -= c - 1 - a; a++; }
+		return Edge(n + q*c + a, n + q*c + a + 1 + p);
+	});
+	auto perm = parlay::random_permutation<int>(n + cliques * c, r.fork(1));
+	return parlay::map(parlay::append(background, planted), [&](const Edge &e) {
+		return Edge(perm[e.first], perm[e.second]);
+	});
+}
+
+// the symmetric CSR of the simple graph: every edge in both directions, targets sorted
+void buildCSR(int n, const parlay::sequence<Edge> &edges, parlay::sequence<uint64_t> &offsets, parlay::sequence<uint32_t> &targets) {
+	auto keys = parlay::map_maybe(parlay::iota<long>(2 * edges.size()), [&](long a) -> std::optional<uint64_t> {
+		Edge e = edges[a / 2];
+		if (e.first == e.second) return std::nullopt;
+		if (a % 2) std::swap(e.first, e.second);
+		return ((uint64_t)(uint32_t)e.first << 32) | (uint32_t)e.second;
+	});
+	keys = parlay::integer_sort(keys);
+	keys = parlay::unique(keys);
+	targets = parlay::map(keys, [](uint64_t x) { return (uint32_t)x; });
+	if (keys.empty()) { // parlay::histogram_by_index() divides by zero on an empty input
+		offsets = parlay::sequence<uint64_t>(n + 1, 0);
+		return;
+	}
+	auto [o, total] = parlay::scan(parlay::histogram_by_index(parlay::delayed_map(keys, [](uint64_t x) {
+		return (long)(x >> 32);
+	}), (long)n));
+	offsets = parlay::map(o, [](long x) { return (uint64_t)x; });
+	offsets.push_back(total);
+}
+
+// one number per line, formatted in parallel blocks
+template <class Seq>
+bool writeNumbers(FILE *fp, const Seq &A) {
+	size_t block = (size_t)1 << 24;
+	for (size_t s = 0; s < A.size(); s += block) {
+		size_t e = std::min(A.size(), s + block);
+		auto lens = parlay::tabulate(e - s, [&](size_t i) {
+			size_t len = 2;
+			for (uint64_t x = A[s+i]; x >= 10; x /= 10) len++;
+			return len;
+		});
+		auto [pos, total] = parlay::scan(lens);
+		parlay::sequence<char> out(total);
+		parlay::parallel_for(0, e - s, [&](size_t i) {
+			char *p = out.data() + pos[i] + lens[i] - 1;
+			*p = '\n';
+			uint64_t x = A[s+i];
+			do { *--p = '0' + x % 10; x /= 10; } while (x > 0);
+		});
+		if (fwrite(out.data(), 1, total, fp) != total) return false;
+	}
+	return true;
+}
+
+bool writeAdj(const std::string &filename, const parlay::sequence<uint64_t> &offsets, const parlay::sequence<uint32_t> &targets) {
+	FILE *fp = fopen(filename.c_str(), "w");
+	if (!fp) return false;
+	bool ok = fprintf(fp, "AdjacencyGraph\n%zu\n%zu\n", offsets.size() - 1, targets.size()) > 0
+	       && writeNumbers(fp, offsets.cut(0, offsets.size() - 1)) && writeNumbers(fp, targets);
+	if (fclose(fp) != 0) ok = false;
+	return ok;
+}
+
+bool writeBinary(const std::string &filename, const parlay::sequence<uint64_t> &offsets, const parlay::sequence<uint32_t> &targets) {
+	FILE *fp = fopen(filename.c_str(), "wb");
+	if (!fp) return false;
+	uint64_t header[3] = { offsets.size() - 1, targets.size(), 3*sizeof(uint64_t) + offsets.size()*sizeof(uint64_t) + targets.size()*sizeof(uint32_t) };
+	bool ok = fwrite(header, sizeof(uint64_t), 3, fp) == 3
+	       && fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), fp) == offsets.size()
+	       && fwrite(targets.data(), sizeof(uint32_t), targets.size(), fp) == targets.size();
+	if (fclose(fp) != 0) ok = false;
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	std::string family, adj_file, bin_file;
+	long n = 1000, m = 10000, seed = 1;
+	int scale = 10, d = 8, rows = 100, cols = 100, cliques = 1, clique_size = 16;
+	auto usage = [&]() {
+		std::cerr << "Usage: " << argv[0] << " <family> [options] [--seed S] [--adj FILE] [--bin FILE]\n";
+		std::cerr << "  rmat --scale S --m M                      RMAT/Kronecker, 2^S vertices, M edges drawn\n";
+		std::cerr << "  gnm --n N --m M                           Erdos-Renyi, M edges drawn\n";
+		std::cerr << "  ba --n N --d D                            Barabasi-Albert, D edges per vertex (arboricity <= D)\n";
+		std::cerr << "  grid --rows R --cols C                    R x C grid (no triangles, arboricity 2)\n";
+		std::cerr << "  planted --n N --m M --cliques K --clique-size C\n";
+		std::cerr << "                                            K cliques of C vertices next to a bipartite G(N,M)\n";
+		std::cerr << "                                            (K*C(C,3) triangles, arboricity >= ceil(C/2))\n";
+		std::cerr << "Only grid and planted graphs have a known triangle count.\n";
+		return 1;
+	};
+	for (int a = 1; a < argc; a++) {
+		std::string arg = argv[a];
+		if (arg.compare(0, 2, "--") != 0) {
+			if (!family.empty()) {
+				std::cerr << "Unexpected argument: " << arg << "\n";
+				return usage();
+			}
+			family = arg;
+			continue;
+		}
+		if (arg != "--n" && arg != "--m" && arg != "--scale" && arg != "--d" && arg != "--rows" && arg != "--cols" && arg != "--cliques"
+		    && arg != "--clique-size" && arg != "--seed" && arg != "--adj" && arg != "--bin") {
+			std::cerr << "Unknown option: " << arg << "\n";
+			return usage();
+		}
+		if (a + 1 == argc) {
+			std::cerr << "Missing value for " << arg << "\n";
+			return usage();
+		}
+		std::string value = argv[++a];
+		if (arg == "--adj") { adj_file = value; continue; }
+		if (arg == "--bin") { bin_file = value; continue; }
+		char *end;
+		long x = strtol(value.c_str(), &end, 10);
+		if (value.empty() || *end != '\0') {
+			std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+			return usage();
+		}
+		if (arg == "--n") n = x;
+		else if (arg == "--m") m = x;
+		else if (arg == "--seed") seed = x;
+		else if (x < INT32_MIN || x > INT32_MAX) {
+			std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+			return usage();
+		}
+		else if (arg == "--scale") scale = x;
+		else if (arg == "--d") d = x;
+		else if (arg == "--rows") rows = x;
+		else if (arg == "--cols") cols = x;
+		else if (arg == "--cliques") cliques = x;
+		else clique_size = x;
+	}
+	bool valid = n >= 1 && m >= 0 && scale >= 1 && scale <= 30 && d >= 1 && rows >= 1 && cols >= 1 && cliques >= 0 && clique_size >= 1
+	             && (family != "planted" || n >= 2 || m == 0);
+	if (!valid || (family != "rmat" && family != "gnm" && family != "ba" && family != "grid" && family != "planted")
+	    || (adj_file.empty() && bin_file.empty())) {
+		return usage();
+	}
+	double start_time = omp_get_wtime();
+
+	parlay::random r(seed);
+	parlay::sequence<Edge> edges;
+	long num_vertices = n;
+	long triangles = -1;
+	int arboricity_lower = 0, arboricity_upper = -1;
+	if (family == "rmat") {
+		num_vertices = 1L << scale;
+		edges = rmatGraph(scale, m, r);
+	} else if (family == "gnm") {
+		edges = gnmGraph(n, m, r);
+	} else if (family == "ba") {
+		// every vertex attaches with at most d edges
+		edges = baGraph(n, d, r);
+		arboricity_upper = d;
+	} else if (family == "grid") {
+		num_vertices = (long)rows * cols;
+		edges = gridGraph(rows, cols);
+		triangles = 0;
+		arboricity_lower = arboricity_upper = (rows > 1 && cols > 1) ? 2 : (num_vertices > 1);
+	} else {
+		num_vertices = n + (long)cliques * clique_size;
+		edges = plantedGraph(n, m, cliques, clique_size, r);
+		triangles = (cliques > 0) ? (long)cliques * clique_size * (clique_size - 1) * (clique_size - 2) / 6 : 0;
+		arboricity_lower = (cliques > 0) ? (clique_size + 1) / 2 : 0;
+	}
+	if (num_vertices > 2147483647L) {
+		std::cerr << "Error: more than 2^31-1 vertices\n";
+		return 1;
+	}
+
+	parlay::sequence<uint64_t> offsets;
+	parlay::sequence<uint32_t> targets;
+	buildCSR(num_vertices, edges, offsets, targets);
+	edges.clear();
+
+	double generation_marker = omp_get_wtime();
+	std::cout << "Generation Time: " << generation_marker - start_time << std::endl;
+
+	if (!adj_file.empty() && !writeAdj(adj_file, offsets, targets)) {
+		std::cerr << "Error writing " << adj_file << "\n";
+		return 1;
+	}
+	if (!bin_file.empty() && !writeBinary(bin_file, offsets, targets)) {
+		std::cerr << "Error writing " << bin_file << "\n";
+		return 1;
+	}
+	std::cout << "Writing Time: " << omp_get_wtime() - generation_marker << std::endl;
+
+	std::cout << "Vertices: " << num_vertices << std::endl;
+	std::cout << "Edges: " << targets.size() / 2 << std::endl;
+	if (triangles >= 0) {
+		std::cout << "Triangles: " << triangles << std::endl;
+	}
+	if (arboricity_lower == arboricity_upper) {
+		std::cout << "Arboricity: " << arboricity_lower << std::endl;
+	} else if (arboricity_lower > 0 || arboricity_upper >= 0) {
+		std::cout << "Arboricity: [" << arboricity_lower << "," << ((arboricity_upper >= 0) ? std::to_string(arboricity_upper) : "") << "]" << std::endl;
+	}
+	return 0;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <cstdlib>
 #include <cmath>
 #include <vector>
 #include <string>
@@ -13,202 +15,222 @@
 #include <parlay/parallel.h>
 #include <parlay/sequence.h>
 
-parlay::sequence<std::pair<int,int>> parseEdges(const std::string &filename, size_t &vertices) {
-	parlay::sequence<std::pair<int,int>> edges;
-	std::ifstream in(filename);
-	if (!in) {
-		std::cerr << "Error opening file: " << filename << "\n";
-		return edges;
-	}
-
-	std::string burn_header;
-	std::getline(in, burn_header);
+#include "arboricity/orientation_file.h"
+#include "triangle_count.h"
 
-	size_t num_vertices, num_edges;
-	in >> num_vertices >> num_edges;
-	vertices = num_vertices;
-
-	std::vector<int> offsets(num_vertices);
-	for (size_t i = 0; i < num_vertices; i++) {
-		in >> offsets[i];
-	}
+int main(int argc, char** argv) {
+	double start_time = omp_get_wtime();
 
-	std::vector<int> target_vertices(num_edges);
-	for (size_t i = 0; i < num_edges; i++) {
-		in >> target_vertices[i];
+	auto usage = [&]() {
+		std::cerr << "Usage: " << argv[0] << " <graph.adj> [--orientation FILE] [--repeat N] [--warmup W] [--flush MB] [--sweep P [--sweep-csv FILE]]\n";
+		return 1;
+	};
+	if (argc < 2) {
+		return usage();
 	}
-
-	edges = parlay::sequence<std::pair<int,int>>(num_edges/2);
-	size_t idx = 0;
-	for (size_t i = 0; i < num_vertices; i++) {
-		size_t start = offsets[i];
-		size_t end;
-		if (i + 1 < num_vertices) {
-			end = offsets[i+1];
-		} else {
-			end = num_edges;
+	std::string data_file  = argv[1];
+	std::string orientation_file;
+	int repeat = 1, warmup = 0;
+	size_t flush_mb = 0;
+	bool print_stats = false;
+	int sweep_max = 0;
+	std::string sweep_csv = "results/scaling.csv";
+	// every option takes a value; an unknown option, a missing value or a number out of range stops
+	// here, so that a benchmark never runs with other settings than the ones asked for
+	for (int a = 2; a < argc; a++) {
+		std::string arg = argv[a];
+		bool numeric = (arg == "--repeat" || arg == "--warmup" || arg == "--flush" || arg == "--sweep");
+		if (!numeric && arg != "--orientation" && arg != "--sweep-csv") {
+			std::cerr << "Unknown option: " << arg << "\n";
+			return usage();
 		}
-		for (size_t j = start; j < end; j++) {
-			if (i < target_vertices[j]) {
-				edges[idx] = {i, target_vertices[j]};
-				idx++;
+		if (a + 1 == argc) {
+			std::cerr << "Missing value for " << arg << "\n";
+			return usage();
+		}
+		std::string value = argv[++a];
+		long x = 0;
+		if (numeric) {
+			char *end;
+			x = strtol(value.c_str(), &end, 10);
+			long min = (arg == "--repeat") ? 1 : 0;
+			if (value.empty() || *end != '\0' || x < min || x > std::numeric_limits<int>::max()) {
+				std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+				return usage();
 			}
 		}
+		if (arg == "--orientation") {
+			orientation_file = value;
+		} else if (arg == "--repeat") {
+			repeat = x;
+			print_stats = true;
+		} else if (arg == "--warmup") {
+			warmup = x;
+			print_stats = true;
+		} else if (arg == "--flush") {
+			flush_mb = x;
+		} else if (arg == "--sweep") {
+			sweep_max = (x > 0) ? x : parlay::num_workers();
+		} else {
+			sweep_csv = value;
+		}
 	}
-	
-	return edges;
-}
-
-// class
-// stores mapping
-// map from vertexID to sequences 
-class Graph {
-
-public:
-	parlay::sequence<parlay::sequence<int>> adjList;
-
-	Graph(size_t &num_vertices, parlay::sequence<std::pair<int,int>> &edges) {
-		vertices = num_vertices;
-		createAdjList(edges);
-	}
-
-	void printAdjList() const {
-		for (int i = 0; i < adjList.size(); i++) {
-			std::cout << "Index: " << i << " Adjacent Nodes: ";
+	size_t num_vertices;
+	parlay::sequence<std::pair<int,int>> edges = parseEdges(data_file, num_vertices);
 
-			for (auto &e : adjList[i]) {
-				std::cout << e << ", ";
-			}
-			std::cout << std::endl;
+	// with an orientation (written by find_arboricity --orientation), the forward adjacency
+	// follows it instead of i < target; it must orient exactly the edges of the graph
+	parlay::sequence<long> offsets;
+	parlay::sequence<int> heads;
+	if (!orientation_file.empty()) {
+		if (!ReadOrientation(orientation_file.c_str(), offsets, heads) || offsets.size() != num_vertices + 1) {
+			std::cerr << "Error reading orientation: " << orientation_file << "\n";
+			return 1;
 		}
-  	}
-
-private:
-	size_t vertices;
-
-	void createAdjList(const parlay::sequence<std::pair<int,int>>& edges) {
-		if (edges.empty()) return;
-
-		adjList = parlay::sequence<parlay::sequence<int>>(vertices);
-
-		for (const auto& e : edges) {
-			int u = e.first;
-			int v = e.second;
-			adjList[u].push_back(v);	
-    	}
+		auto arcs = parlay::flatten(parlay::tabulate(num_vertices, [&](size_t u) {
+			return parlay::tabulate(offsets[u+1] - offsets[u], [&, u](long k) {
+				return std::make_pair((int)u, heads[offsets[u] + k]);
+			});
+		}));
+		auto key = [](const std::pair<int,int> &e) {
+			return ((unsigned long long)(unsigned)std::min(e.first, e.second) << 32) | (unsigned)std::max(e.first, e.second);
+		};
+		if (parlay::integer_sort(parlay::map(arcs, key)) != parlay::integer_sort(parlay::map(edges, key))) {
+			std::cerr << "Error: the orientation does not match the edges of " << data_file << "\n";
+			return 1;
+		}
+		edges = std::move(arcs);
 	}
-};
-
-class Solver {
-
-public:
-	Solver(const Graph *g, const parlay::sequence<std::pair<int,int>> &edges) : 
-		graph(g), edges(edges) {}
+	
+	double parsing_marker = omp_get_wtime();
+	double parsing_time = parsing_marker - start_time;
+	std::cout << "Parsing Time: " << parsing_time << std::endl;
 
-	long long getTriangleCount() { return triangle_count; }
+	// the graph is parsed once; every run builds the adjacency lists and counts the triangles. The warmup
+	// runs are not timed, and with --flush every run starts with the allocator's pool released and the
+	// CPU caches overwritten by a buffer of MB megabytes
+	int runs = warmup + repeat;
+	std::vector<double> construction_times, solving_times, total_times;
+	parlay::sequence<char> flush_buffer(flush_mb << 20);
+	long long triangles = -1;
+	size_t max_out_degree = 0;
+	auto measure = [&]() {
+		construction_times.clear();
+		solving_times.clear();
+		total_times.clear();
+		for (int run = 0; run < runs; run++) {
+			if (flush_mb > 0) {
+				parlay::internal::memory_clear();
+				parlay::parallel_for(0, flush_buffer.size(), [&](size_t i) { flush_buffer[i] = (char)(i + run); });
+			}
 
-	void computeTriangles() {
-		parlay::sequence<long long> counts(edges.size());
+			double run_start = omp_get_wtime();
+			Graph *g = orientation_file.empty() ? new Graph(num_vertices, edges) : new Graph(num_vertices, offsets, heads);
+			double construction_marker = omp_get_wtime();
 
-		parlay::parallel_for(0, edges.size(), [&](int i) {
-			auto e = edges[i];
-			counts[i] = countSharedVertices(graph->adjList[e.first], graph->adjList[e.second], e.first, e.second);
-		});
+			Solver* s = new Solver(g, edges, !orientation_file.empty());
+			s->computeTriangles();
+			double end_time = omp_get_wtime();
 
-		triangle_count = parlay::reduce(counts, parlay::addm<long long>());
-	}
-	
-private:
-	/**
-	 * Private variables:
-	 * triangle_count is a running total of triangles
-	 * graph is a pointer to the 
-	 */
-	long long triangle_count = 0;
-	const Graph *graph;
-	parlay::sequence<std::pair<int,int>> edges;
-
-	long long countSharedVertices(const parlay::sequence<int>& u_seq, 
-								  const parlay::sequence<int>& v_seq,
-								  size_t u, size_t v) {
-		long long count = 0;
-		int binary_search_factor = 100;
-		size_t u_seq_size = u_seq.size();
-		size_t v_seq_size = v_seq.size();
-		if (u_seq_size * binary_search_factor < v_seq_size) {
-			for (auto &w : u_seq) {
-				count += queryEdge(v, w);
+			if (triangles >= 0 && s->getTriangleCount() != triangles) {
+				std::cerr << "Error: run " << run << " counted " << s->getTriangleCount() << " triangles instead of " << triangles << "\n";
+				return false;
 			}
-		} else if (u_seq_size > v_seq_size * binary_search_factor) {
-			for (auto &w : v_seq) {
-				count += queryEdge(u, w);
+			triangles = s->getTriangleCount();
+			if (!orientation_file.empty()) {
+				max_out_degree = parlay::reduce(parlay::map(g->adjList, [](const parlay::sequence<int> &a) { return a.size(); }), parlay::maxm<size_t>());
 			}
-		} else {
-			size_t u_idx = 0;
-			size_t v_idx = 0;
-			 
-			while (true) {
-				if (u_seq[u_idx] < v_seq[v_idx]) {
-					u_idx++;
-					if (u_idx == u_seq_size) {
-						break;
-					}
-				} else if (u_seq[u_idx] > v_seq[v_idx]) {
-					v_idx++;
-					if (v_idx == v_seq_size) {
-						break;
-					}
-				} else { // w[w_idx] = u[u_udx]
-					count++; 
-					u_idx++;
-					v_idx++;
-					if (u_idx == u_seq_size) {
-						break;
-					}
-					if (v_idx == v_seq_size) {
-						break;
-					}
-				}
+			delete s;
+			delete g;
+
+			if (run >= warmup) {
+				construction_times.push_back(construction_marker - run_start);
+				solving_times.push_back(end_time - construction_marker);
+				total_times.push_back(end_time - run_start);
 			}
 		}
-		return count;
-	}
-
-	int queryEdge(int u, int v) {
-		return std::binary_search(graph->adjList[u].begin(), graph->adjList[u].end(), v);
+		return true;
 	};
-};
 
-int main(int argc, char** argv) {
-	double start_time = omp_get_wtime();
+	// min, median, mean and sample standard deviation over the timed runs
+	auto stats = [](std::vector<double> t) {
+		std::sort(t.begin(), t.end());
+		double mean = 0, var = 0;
+		for (double x : t) mean += x / t.size();
+		for (double x : t) var += (x - mean) * (x - mean);
+		double stddev = (t.size() > 1) ? std::sqrt(var / (t.size() - 1)) : 0;
+		double median = (t.size() % 2) ? t[t.size() / 2] : (t[t.size() / 2 - 1] + t[t.size() / 2]) / 2;
+		return std::vector<double>{ t[0], median, mean, stddev };
+	};
 
-	std::string data_file  = argv[1];
-	size_t num_vertices;
-	parlay::sequence<std::pair<int,int>> edges = parseEdges(data_file, num_vertices);
-	
-	double parsing_marker = omp_get_wtime();
-	double parsing_time = parsing_marker - start_time;
-	std::cout << "Parsing Time: " << parsing_time << std::endl;
+	if (sweep_max > 0) {
+		// the median times at 1, 2, 4, ... workers and at sweep_max, each with a scheduler of that size;
+		// the output below is then the one of the last (largest) scheduler
+		std::vector<int> workers;
+		for (int p = 1; p < sweep_max; p *= 2) workers.push_back(p);
+		workers.push_back(sweep_max);
+		const char *phases[3] = { "construction", "triangles", "total" };
+		std::vector<std::vector<double>> medians(3);
+		for (int p : workers) {
+			bool ok = true;
+			parlay::execute_with_scheduler(p, [&] { ok = measure(); });
+			if (!ok) return 1;
+			medians[0].push_back(stats(construction_times)[1]);
+			medians[1].push_back(stats(solving_times)[1]);
+			medians[2].push_back(stats(total_times)[1]);
+		}
 
-	Graph *g = new Graph(num_vertices, edges);
+		std::string name = data_file.substr(data_file.find_last_of('/') + 1);
+		name = name.substr(0, name.find_last_of('.'));
+		std::ifstream existing(sweep_csv);
+		bool header = !existing || existing.peek() == std::ifstream::traits_type::eof();
+		existing.close();
+		std::ofstream csv(sweep_csv, std::ios::app);
+		if (!csv) {
+			std::cerr << "Error opening " << sweep_csv << "\n";
+			return 1;
+		}
+		if (header) {
+			csv << "filename,phase,workers,time,speedup,efficiency\n";
+		}
+		for (int f = 0; f < 3; f++) {
+			printf("%-14s %8s %12s %8s %10s\n", phases[f], "workers", "time", "speedup", "efficiency");
+			for (size_t k = 0; k < workers.size(); k++) {
+				double speedup = medians[f][0] / medians[f][k];
+				printf("%-14s %8d %12.6f %8.2f %10.2f\n", "", workers[k], medians[f][k], speedup, speedup / workers[k]);
+				csv << name << "," << phases[f] << "," << workers[k] << "," << medians[f][k] << "," << speedup << "," << speedup / workers[k] << "\n";
+			}
+		}
+	} else if (!measure()) {
+		return 1;
+	}
 
-	double construction_marker = omp_get_wtime();
-	double construction_time = construction_marker - parsing_marker;
-	std::cout << "Adjacency List Construction Time: " << construction_time << std::endl;
+	auto construction = stats(construction_times);
+	auto solving = stats(solving_times);
+	auto total = stats(total_times);
 
-	Solver* s = new Solver(g, edges);
-	s->computeTriangles();
-	long long triangles = s->getTriangleCount();
-	
-	double end_time = omp_get_wtime();
-	double solving_time = end_time - construction_marker;
-	std::cout << "Computing Triangles Time: " << solving_time << std::endl;
-	
-	double elapsed_exclude_parser = end_time - parsing_marker;
-	double elapsed = end_time - start_time;
-	std::cout << "Total Time (excluding parser): " << elapsed_exclude_parser << std::endl;
-	std::cout << "Total Time Elapsed: " << elapsed << std::endl;
+	// with --repeat, the times below are medians
+	std::cout << "Adjacency List Construction Time: " << construction[1] << std::endl;
+	if (!orientation_file.empty()) {
+		std::cout << "Orientation Max Out-Degree: " << max_out_degree << std::endl;
+	}
+	std::cout << "Computing Triangles Time: " << solving[1] << std::endl;
+	std::cout << "Total Time (excluding parser): " << total[1] << std::endl;
+	std::cout << "Total Time Elapsed: " << parsing_time + total[1] << std::endl;
 
 	std::cout << "Triangles: " << triangles << std::endl;
+
+	if (print_stats) {
+		auto json = [](const char *name, const std::vector<double> &t) {
+			std::cout << ", \"" << name << "\": {\"min\": " << t[0] << ", \"median\": " << t[1]
+			          << ", \"mean\": " << t[2] << ", \"stddev\": " << t[3] << "}";
+		};
+		std::cout << "{\"repeat\": " << repeat << ", \"warmup\": " << warmup << ", \"flush_mb\": " << flush_mb
+		          << ", \"triangles\": " << triangles << ", \"parsing\": " << parsing_time;
+		json("construction", construction);
+		json("triangles_time", solving);
+		json("total", total);
+		std::cout << "}" << std::endl;
+	}
 	return 0;
 }
\ No newline at end of file
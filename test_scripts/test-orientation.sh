@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# Checks that ./final counts the same triangles with --orientation as without, on K4 oriented with a directed
+# 3-cycle 0->1->2->0 and the arcs 3->0, 3->1, 3->2. The cycle is only found by the second (cyclic) pass of the
+# triangle counter, once from each of its arcs, and the three transitive triangles by the first.
+# Run from the repository root after `make final`.
+
+set -e
+
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+NC='\033[0m'
+
+log() {
+  echo -e "${GREEN}==> $1${NC}" >&2
+}
+
+error() {
+  echo -e "${RED}Error: $1${NC}" >&2
+  exit 1
+}
+
+# $1 in $2 bytes, little-endian (the orientation file is in native byte order, see arboricity/orientation_file.h)
+le() {
+  local i
+  for ((i = 0; i < $2; i++)); do
+    printf "\\x$(printf %02x $(( ($1 >> (8 * i)) & 255 )))"
+  done
+}
+
+[ -x ./final ] || error "./final not found, run make final first"
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf "AdjacencyGraph\n4\n12\n0\n3\n6\n9\n1\n2\n3\n0\n2\n3\n0\n1\n3\n0\n1\n2\n" > "$TMP/k4.adj"
+
+# "ARBORNT1", node_num, arc_num, offsets[node_num+1] (longs), heads[arc_num] (ints)
+{
+  printf "ARBORNT1"
+  le 4 8; le 6 8
+  for o in 0 1 2 3 6; do le $o 8; done
+  for h in 1 2 0 0 1 2; do le $h 4; done
+} > "$TMP/k4.orient"
+
+triangles() {
+  ./final "$@" --repeat 1 | grep "^Triangles:" | awk '{print $2}'
+}
+
+plain=$(triangles "$TMP/k4.adj")
+oriented=$(triangles "$TMP/k4.adj" --orientation "$TMP/k4.orient")
+
+log "Triangles: $plain without, $oriented with the orientation"
+[ "$plain" = 4 ] || error "expected 4 triangles, got $plain"
+[ "$oriented" = "$plain" ] || error "the orientation gives $oriented triangles instead of $plain"
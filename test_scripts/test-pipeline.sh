@@ -125,12 +125,9 @@ log "Running DFFs Implementation"
 DFFS_OUT="results/DFFS_RESULT_${BASENAME%.txt}.txt"
 > "$DFFS_OUT"
 
-for i in {1..30}; do
-  echo "=== Run $i ===" >> "$DFFS_OUT"
-  run_in_dir . ./final "test_graphs/$ADJ_FILENAME" \
-      >> "$DFFS_OUT" 2>&1
-  echo >> "$DFFS_OUT"
-done
+# one process: the graph is parsed once, and the reported times are medians over 30 runs
+run_in_dir . ./final "test_graphs/$ADJ_FILENAME" --repeat 30 --warmup 1 \
+    >> "$DFFS_OUT" 2>&1
 
 clean_dffs=$(sed -E 's/\x1b\[[0-9;]*m//g' "$DFFS_OUT")
 
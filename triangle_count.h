@@ -0,0 +1,212 @@
+#ifndef TRIANGLE_COUNT_H
+#define TRIANGLE_COUNT_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+
+#include <parlay/primitives.h>
+#include <parlay/parallel.h>
+#include <parlay/sequence.h>
+
+// The triangle counter of ./final (main.cpp), shared with the analysis driver in arboricity/.
+
+inline parlay::sequence<std::pair<int,int>> parseEdges(const std::string &filename, size_t &vertices) {
+	parlay::sequence<std::pair<int,int>> edges;
+	std::ifstream in(filename);
+	if (!in) {
+		std::cerr << "Error opening file: " << filename << "\n";
+		return edges;
+	}
+
+	std::string burn_header;
+	std::getline(in, burn_header);
+
+	size_t num_vertices, num_edges;
+	in >> num_vertices >> num_edges;
+	vertices = num_vertices;
+
+	std::vector<int> offsets(num_vertices);
+	for (size_t i = 0; i < num_vertices; i++) {
+		in >> offsets[i];
+	}
+
+	std::vector<int> target_vertices(num_edges);
+	for (size_t i = 0; i < num_edges; i++) {
+		in >> target_vertices[i];
+	}
+
+	edges = parlay::sequence<std::pair<int,int>>(num_edges/2);
+	size_t idx = 0;
+	for (size_t i = 0; i < num_vertices; i++) {
+		size_t start = offsets[i];
+		size_t end;
+		if (i + 1 < num_vertices) {
+			end = offsets[i+1];
+		} else {
+			end = num_edges;
+		}
+		for (size_t j = start; j < end; j++) {
+			if (i < target_vertices[j]) {
+				edges[idx] = {i, target_vertices[j]};
+				idx++;
+			}
+		}
+	}
+	
+	return edges;
+}
+
+// class
+// stores mapping
+// map from vertexID to sequences 
+class Graph {
+
+public:
+	parlay::sequence<parlay::sequence<int>> adjList;
+
+	Graph(size_t &num_vertices, parlay::sequence<std::pair<int,int>> &edges) {
+		vertices = num_vertices;
+		createAdjList(edges);
+	}
+
+	// forward adjacency in CSR form, e.g. an orientation (see arboricity/orientation_file.h):
+	// adjList[u] holds the heads of the arcs leaving u, already sorted
+	Graph(size_t &num_vertices, const parlay::sequence<long> &offsets, const parlay::sequence<int> &heads) {
+		vertices = num_vertices;
+		adjList = parlay::tabulate(vertices, [&](size_t u) {
+			return parlay::to_sequence(heads.cut(offsets[u], offsets[u+1]));
+		});
+	}
+
+	void printAdjList() const {
+		for (int i = 0; i < adjList.size(); i++) {
+			std::cout << "Index: " << i << " Adjacent Nodes: ";
+
+			for (auto &e : adjList[i]) {
+				std::cout << e << ", ";
+			}
+			std::cout << std::endl;
+		}
+  	}
+
+private:
+	size_t vertices;
+
+	void createAdjList(const parlay::sequence<std::pair<int,int>>& edges) {
+		if (edges.empty()) return;
+
+		adjList = parlay::sequence<parlay::sequence<int>>(vertices);
+
+		for (const auto& e : edges) {
+			int u = e.first;
+			int v = e.second;
+			adjList[u].push_back(v);	
+    	}
+	}
+};
+
+class Solver {
+
+public:
+	// edges are the arcs of the forward adjacency. With cyclic, the orientation does not come
+	// from an order of the vertices, so a triangle can also be a directed cycle
+	Solver(const Graph *g, const parlay::sequence<std::pair<int,int>> &edges, bool cyclic = false) : 
+		graph(g), edges(edges), cyclic(cyclic) {}
+
+	long long getTriangleCount() { return triangle_count; }
+
+	void computeTriangles() {
+		parlay::sequence<long long> counts(edges.size());
+
+		parlay::parallel_for(0, edges.size(), [&](int i) {
+			auto e = edges[i];
+			counts[i] = countSharedVertices(graph->adjList[e.first], graph->adjList[e.second], e.first, e.second);
+		});
+
+		triangle_count = parlay::reduce(counts, parlay::addm<long long>());
+
+		// the loop above counts each transitive triangle once, at the arc between its two
+		// vertices with out-arcs inside it; a directed cycle u->v->w->u is found from each of its arcs
+		if (cyclic) {
+			parlay::parallel_for(0, edges.size(), [&](int i) {
+				auto e = edges[i];
+				long long c = 0;
+				for (auto &w : graph->adjList[e.second]) {
+					c += queryEdge(w, e.first);
+				}
+				counts[i] = c;
+			});
+			triangle_count += parlay::reduce(counts, parlay::addm<long long>()) / 3;
+		}
+	}
+	
+private:
+	/**
+	 * Private variables:
+	 * triangle_count is a running total of triangles
+	 * graph is a pointer to the 
+	 */
+	long long triangle_count = 0;
+	const Graph *graph;
+	parlay::sequence<std::pair<int,int>> edges;
+	bool cyclic;
+
+	long long countSharedVertices(const parlay::sequence<int>& u_seq, 
+								  const parlay::sequence<int>& v_seq,
+								  size_t u, size_t v) {
+		long long count = 0;
+		int binary_search_factor = 100;
+		size_t u_seq_size = u_seq.size();
+		size_t v_seq_size = v_seq.size();
+		if (u_seq_size == 0 || v_seq_size == 0) {
+			return 0;
+		}
+		if (u_seq_size * binary_search_factor < v_seq_size) {
+			for (auto &w : u_seq) {
+				count += queryEdge(v, w);
+			}
+		} else if (u_seq_size > v_seq_size * binary_search_factor) {
+			for (auto &w : v_seq) {
+				count += queryEdge(u, w);
+			}
+		} else {
+			size_t u_idx = 0;
+			size_t v_idx = 0;
+			 
+			while (true) {
+				if (u_seq[u_idx] < v_seq[v_idx]) {
+					u_idx++;
+					if (u_idx == u_seq_size) {
+						break;
+					}
+				} else if (u_seq[u_idx] > v_seq[v_idx]) {
+					v_idx++;
+					if (v_idx == v_seq_size) {
+						break;
+					}
+				} else { // w[w_idx] = u[u_udx]
+					count++; 
+					u_idx++;
+					v_idx++;
+					if (u_idx == u_seq_size) {
+						break;
+					}
+					if (v_idx == v_seq_size) {
+						break;
+					}
+				}
+			}
+		}
+		return count;
+	}
+
+	int queryEdge(int u, int v) {
+		return std::binary_search(graph->adjList[u].begin(), graph->adjList[u].end(), v);
+	};
+};
+
+#endif